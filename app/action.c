@@ -33,6 +33,7 @@
 #include "driver/uart.h"
 #include "functions.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/inputbox.h"
 #include "ui/ui.h"
@@ -90,7 +91,7 @@ void ACTION_Monitor(void)
 	
 	if (g_scan_state_dir != SCAN_OFF)
 	{
-		g_scan_pause_delay_in_10ms = scan_pause_delay_in_1_10ms;
+		SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, scan_pause_delay_in_1_10ms);
 		g_schedule_scan_listen    = false;
 		g_scan_pause_mode         = true;
 	}
@@ -98,7 +99,7 @@ void ACTION_Monitor(void)
 	#ifdef g_power_save_expired
 		if (g_eeprom.dual_watch == DUAL_WATCH_OFF && g_is_noaa_mode)
 		{
-			g_noaa_count_down_10ms = noaa_count_down_10ms;
+			SCHEDULER_StartTimer(TIMER_NOAA, noaa_count_down_10ms);
 			g_schedule_noaa        = false;
 		}
 	#endif
@@ -200,7 +201,7 @@ void ACTION_Scan(bool bRestart)
 
 					// jump to the next channel
 					CHANNEL_Next(true, g_scan_state_dir);
-					g_scan_pause_delay_in_10ms = 1;
+					SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, 1);
 					g_schedule_scan_listen    = false;
 
 					g_update_status = true;
@@ -242,7 +243,7 @@ void ACTION_Scan(bool bRestart)
 
 		// jump to the next channel
 		CHANNEL_Next(true, g_scan_state_dir);
-		g_scan_pause_delay_in_10ms = 1;
+		SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, 1);
 		g_schedule_scan_listen    = false;
 
 		g_update_status = true;
@@ -128,14 +128,8 @@ void AIRCOPY_StorePacket(void)
 
 			if (eeprom_addr < AIRCOPY_LAST_EEPROM_ADDR)
 			{
-				const uint16_t *pData = &g_aircopy_fsk_buffer[2];
-
-				for (i = 0; i < 8; i++)
-				{
-					EEPROM_WriteBuffer(eeprom_addr, pData);
-					pData       += 4;
-					eeprom_addr += 8;
-				}
+				EEPROM_Write(eeprom_addr, &g_aircopy_fsk_buffer[2], 64);
+				eeprom_addr += 64;
 
 				//g_aircopy_block_number++;
 				g_aircopy_block_number = eeprom_addr / 64;
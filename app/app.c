@@ -40,6 +40,7 @@
 	#include "driver/bk1080.h"
 #endif
 #include "driver/bk4819.h"
+#include "driver/eeprom.h"
 #include "driver/gpio.h"
 #include "driver/keyboard.h"
 #include "driver/st7565.h"
@@ -51,8 +52,12 @@
 #include "frequencies.h"
 #include "functions.h"
 #include "helper/battery.h"
+#ifdef ENABLE_PROFILER
+	#include "helper/profiler.h"
+#endif
 #include "misc.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #if defined(ENABLE_OVERLAY)
 	#include "sram-overlay.h"
@@ -103,7 +108,7 @@ static void APP_CheckForIncoming(void)
 		if (g_css_scan_mode != CSS_SCAN_MODE_OFF && g_rx_reception_mode == RX_MODE_NONE)
 		{	// CTCSS/DTS scanning
 
-			g_scan_pause_delay_in_10ms = scan_pause_delay_in_5_10ms;
+			SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, scan_pause_delay_in_5_10ms);
 			g_schedule_scan_listen    = false;
 			g_rx_reception_mode       = RX_MODE_DETECTED;
 		}
@@ -114,7 +119,7 @@ static void APP_CheckForIncoming(void)
 			#ifdef ENABLE_NOAA
 				if (g_is_noaa_mode)
 				{
-					g_noaa_count_down_10ms = noaa_count_down_3_10ms;
+					SCHEDULER_StartTimer(TIMER_NOAA, noaa_count_down_3_10ms);
 					g_schedule_noaa        = false;
 				}
 			#endif
@@ -146,7 +151,7 @@ static void APP_CheckForIncoming(void)
 			return;
 		}
 
-		g_dual_watch_count_down_10ms = dual_watch_count_after_rx_10ms;
+		SCHEDULER_StartTimer(TIMER_DUAL_WATCH, dual_watch_count_after_rx_10ms);
 		g_schedule_dual_watch       = false;
 
 		// let the user see DW is not active
@@ -168,7 +173,7 @@ static void APP_CheckForIncoming(void)
 			return;
 		}
 
-		g_scan_pause_delay_in_10ms = scan_pause_delay_in_3_10ms;
+		SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, scan_pause_delay_in_3_10ms);
 		g_schedule_scan_listen    = false;
 	}
 
@@ -207,7 +212,7 @@ static void APP_HandleIncoming(void)
 	#ifdef ENABLE_NOAA
 		if (IS_NOAA_CHANNEL(g_rx_vfo->channel_save) && g_noaa_count_down_10ms > 0)
 		{
-			g_noaa_count_down_10ms = 0;
+			SCHEDULER_StopTimer(TIMER_NOAA);
 			flag = true;
 		}
 	#endif
@@ -237,7 +242,7 @@ static void APP_HandleIncoming(void)
 			{
 				if (g_rx_reception_mode == RX_MODE_DETECTED)
 				{
-					g_dual_watch_count_down_10ms = dual_watch_count_after_1_10ms;
+					SCHEDULER_StartTimer(TIMER_DUAL_WATCH, dual_watch_count_after_1_10ms);
 					g_schedule_dual_watch       = false;
 
 					g_rx_reception_mode = RX_MODE_LISTENING;
@@ -337,7 +342,7 @@ static void APP_HandleReceive(void)
 					if (!g_found_CTCSS)
 					{
 						g_found_CTCSS = true;
-						g_found_CTCSS_count_down_10ms = 100;   // 1 sec
+						SCHEDULER_StartTimer(TIMER_FOUND_CTCSS, 100);   // 1 sec
 					}
 
 					if (g_CxCSS_tail_found)
@@ -357,7 +362,7 @@ static void APP_HandleReceive(void)
 					if (!g_found_CDCSS)
 					{
 						g_found_CDCSS = true;
-						g_found_CDCSS_count_down_10ms = 100;   // 1 sec
+						SCHEDULER_StartTimer(TIMER_FOUND_CDCSS, 100);   // 1 sec
 					}
 
 					if (g_CxCSS_tail_found)
@@ -400,7 +405,7 @@ Skip:
 
 			#ifdef ENABLE_NOAA
 				if (IS_NOAA_CHANNEL(g_rx_vfo->channel_save))
-					g_noaa_count_down_10ms = 300;         // 3 sec
+					SCHEDULER_StartTimer(TIMER_NOAA, 300);         // 3 sec
 			#endif
 
 			g_update_display = true;
@@ -413,7 +418,7 @@ Skip:
 						break;
 
 					case SCAN_RESUME_CO:
-						g_scan_pause_delay_in_10ms = scan_pause_delay_in_7_10ms;
+						SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, scan_pause_delay_in_7_10ms);
 						g_schedule_scan_listen    = false;
 						break;
 
@@ -430,7 +435,7 @@ Skip:
 			{
 				GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_AUDIO_PATH);
 
-				g_tail_tone_elimination_count_down_10ms = 20;
+				SCHEDULER_StartTimer(TIMER_TAIL_TONE, 20);
 				g_flag_tail_tone_elimination_complete   = false;
 				g_end_of_rx_detected_maybe = true;
 				g_enable_speaker        = false;
@@ -501,7 +506,7 @@ void APP_StartListening(function_type_t Function, const bool reset_am_fix)
 			case SCAN_RESUME_TO:
 				if (!g_scan_pause_mode)
 				{
-					g_scan_pause_delay_in_10ms = scan_pause_delay_in_1_10ms;
+					SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, scan_pause_delay_in_1_10ms);
 					g_schedule_scan_listen    = false;
 					g_scan_pause_mode         = true;
 				}
@@ -509,7 +514,7 @@ void APP_StartListening(function_type_t Function, const bool reset_am_fix)
 
 			case SCAN_RESUME_CO:
 			case SCAN_RESUME_SE:
-				g_scan_pause_delay_in_10ms = 0;
+				SCHEDULER_StopTimer(TIMER_SCAN_PAUSE);
 				g_schedule_scan_listen    = false;
 				break;
 		}
@@ -524,7 +529,7 @@ void APP_StartListening(function_type_t Function, const bool reset_am_fix)
 			g_rx_vfo->pRX->frequency      = NoaaFrequencyTable[g_noaa_channel];
 			g_rx_vfo->pTX->frequency      = NoaaFrequencyTable[g_noaa_channel];
 			g_eeprom.screen_channel[chan] = g_rx_vfo->channel_save;
-			g_noaa_count_down_10ms        = 500;   // 5 sec
+			SCHEDULER_StartTimer(TIMER_NOAA, 500);   // 5 sec
 			g_schedule_noaa               = false;
 		}
 	#endif
@@ -537,7 +542,7 @@ void APP_StartListening(function_type_t Function, const bool reset_am_fix)
 	    g_eeprom.dual_watch != DUAL_WATCH_OFF)
 	{	// not scanning, dual watch is enabled
 
-		g_dual_watch_count_down_10ms = dual_watch_count_after_2_10ms;
+		SCHEDULER_StartTimer(TIMER_DUAL_WATCH, dual_watch_count_after_2_10ms);
 		g_schedule_dual_watch       = false;
 
 		g_rx_vfo_is_active = true;
@@ -560,7 +565,14 @@ void APP_StartListening(function_type_t Function, const bool reset_am_fix)
 			{	// AM RX mode
 				if (reset_am_fix)
 					AM_fix_reset(chan);      // TODO: only reset it when moving channel/frequency
-				AM_fix_10ms(chan);
+
+				#ifdef ENABLE_PROFILER
+					const uint32_t start = PROFILER_Stamp();
+					AM_fix_10ms(chan);
+					PROFILER_Record(PROFILE_AM_FIX, start);
+				#else
+					AM_fix_10ms(chan);
+				#endif
 			}
 			else
 			{	// FM RX mode
@@ -641,9 +653,9 @@ static void FREQ_NextChannel(void)
 	RADIO_SetupRegisters(true);
 
 	#ifdef ENABLE_FASTER_CHANNEL_SCAN
-		g_scan_pause_delay_in_10ms = 9;   // 90ms
+		SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, 9);   // 90ms
 	#else
-		g_scan_pause_delay_in_10ms = scan_pause_delay_in_6_10ms;
+		SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, scan_pause_delay_in_6_10ms);
 	#endif
 
 	g_scan_keep_frequency = false;
@@ -741,9 +753,9 @@ static void USER_NextChannel(void)
 	}
 
 	#ifdef ENABLE_FASTER_CHANNEL_SCAN
-		g_scan_pause_delay_in_10ms = 9;  // 90ms .. <= ~60ms it misses signals (squelch response and/or PLL lock time) ?
+		SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, 9);  // 90ms .. <= ~60ms it misses signals (squelch response and/or PLL lock time) ?
 	#else
-		g_scan_pause_delay_in_10ms = scan_pause_delay_in_3_10ms;
+		SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, scan_pause_delay_in_3_10ms);
 	#endif
 
 	g_scan_keep_frequency = false;
@@ -792,27 +804,25 @@ static void DUALWATCH_Alternate(void)
 	RADIO_SetupRegisters(false);
 
 	#ifdef ENABLE_NOAA
-		g_dual_watch_count_down_10ms = g_is_noaa_mode ? dual_watch_count_noaa_10ms : dual_watch_count_toggle_10ms;
+		SCHEDULER_StartTimer(TIMER_DUAL_WATCH, g_is_noaa_mode ? dual_watch_count_noaa_10ms : dual_watch_count_toggle_10ms);
 	#else
-		g_dual_watch_count_down_10ms = dual_watch_count_toggle_10ms;
+		SCHEDULER_StartTimer(TIMER_DUAL_WATCH, dual_watch_count_toggle_10ms);
 	#endif
 }
 
 void APP_CheckRadioInterrupts(void)
 {
+	BK4819_event_t event;
+
 	if (g_screen_to_display == DISPLAY_SCANNER)
 		return;
 
-	while (BK4819_ReadRegister(BK4819_REG_0C) & 1u)
-	{	// BK chip interrupt request
-
-		uint16_t interrupt_status_bits;
+	BK4819_FetchEvents();
 
-		// reset the interrupt ?
-		BK4819_WriteRegister(BK4819_REG_02, 0);
+	while (BK4819_GetEvent(&event))
+	{	// BK chip interrupt request
 
-		// fetch the interrupt status bits
-		interrupt_status_bits = BK4819_ReadRegister(BK4819_REG_02);
+		const uint16_t interrupt_status_bits = event.status;
 
 		// 0 = no phase shift
 		// 1 = 120deg phase shift
@@ -824,7 +834,7 @@ void APP_CheckRadioInterrupts(void)
 
 		if (interrupt_status_bits & BK4819_REG_02_DTMF_5TONE_FOUND)
 		{	// save the RX'ed DTMF character
-			const char c = DTMF_GetCharacter(BK4819_GetDTMF_5TONE_Code());
+			const char c = DTMF_GetCharacter(event.code);
 			if (c != 0xff)
 			{
 				if (g_current_function != FUNCTION_TRANSMIT)
@@ -889,14 +899,14 @@ void APP_CheckRadioInterrupts(void)
 				{
 					if (g_current_function == FUNCTION_POWER_SAVE && !g_rx_idle_mode)
 					{
-						g_power_save_10ms = power_save2_10ms;
+						SCHEDULER_StartTimer(TIMER_POWER_SAVE, power_save2_10ms);
 						g_power_save_expired = false;
 					}
 
 					if (g_eeprom.dual_watch != DUAL_WATCH_OFF &&
 					   (g_schedule_dual_watch || g_dual_watch_count_down_10ms < dual_watch_count_after_vox_10ms))
 					{
-						g_dual_watch_count_down_10ms = dual_watch_count_after_vox_10ms;
+						SCHEDULER_StartTimer(TIMER_DUAL_WATCH, dual_watch_count_after_vox_10ms);
 						g_schedule_dual_watch = false;
 
 						// let the user see DW is not active
@@ -931,8 +941,8 @@ void APP_CheckRadioInterrupts(void)
 				if (g_screen_to_display == DISPLAY_AIRCOPY && g_aircopy_state == AIRCOPY_RX)
 				{
 					unsigned int i;
-					for (i = 0; i < 4; i++)
-						g_aircopy_fsk_buffer[g_aircopy_fsk_write_index++] = BK4819_ReadRegister(BK4819_REG_5F);
+					for (i = 0; i < ARRAY_SIZE(event.data); i++)
+						g_aircopy_fsk_buffer[g_aircopy_fsk_write_index++] = event.data[i];
 					AIRCOPY_StorePacket();
 				}
 			}
@@ -997,7 +1007,7 @@ void APP_EndTransmission(void)
 		if (g_vox_noise_detected)
 		{
 			if (g_vox_lost)
-				g_vox_stop_count_down_10ms = vox_stop_count_down_10ms;
+				SCHEDULER_StartTimer(TIMER_VOX_STOP, vox_stop_count_down_10ms);
 			else
 			if (g_vox_stop_count_down_10ms == 0)
 				g_vox_noise_detected = false;
@@ -1135,7 +1145,7 @@ void APP_Update(void)
 				NOAA_IncreaseChannel();
 				RADIO_SetupRegisters(false);
 
-				g_noaa_count_down_10ms = 7;      // 70ms
+				SCHEDULER_StartTimer(TIMER_NOAA, 7);      // 70ms
 				g_schedule_noaa        = false;
 			}
 		}
@@ -1212,7 +1222,7 @@ void APP_Update(void)
 			    g_screen_to_display != DISPLAY_MAIN  ||
 			    g_dtmf_call_state != DTMF_CALL_STATE_NONE)
 			{
-				g_battery_save_count_down_10ms   = battery_save_count_10ms;
+				SCHEDULER_StartTimer(TIMER_BATTERY_SAVE, battery_save_count_10ms);
 			}
 			else
 			if ((IS_NOT_NOAA_CHANNEL(g_eeprom.screen_channel[0]) &&
@@ -1223,7 +1233,7 @@ void APP_Update(void)
 			}
 			else
 			{
-				g_battery_save_count_down_10ms = battery_save_count_10ms;
+				SCHEDULER_StartTimer(TIMER_BATTERY_SAVE, battery_save_count_10ms);
 			}
 		#else
 			if (
@@ -1238,7 +1248,7 @@ void APP_Update(void)
 			    g_screen_to_display != DISPLAY_MAIN  ||
 			    g_dtmf_call_state != DTMF_CALL_STATE_NONE)
 			{
-				g_battery_save_count_down_10ms = battery_save_count_10ms;
+				SCHEDULER_StartTimer(TIMER_BATTERY_SAVE, battery_save_count_10ms);
 			}
 			else
 			{
@@ -1279,7 +1289,7 @@ void APP_Update(void)
 
 				FUNCTION_Init();
 
-				g_power_save_10ms = power_save1_10ms; // come back here in a bit
+				SCHEDULER_StartTimer(TIMER_POWER_SAVE, power_save1_10ms); // come back here in a bit
 				g_rx_idle_mode    = false;           // RX is awake
 			}
 			else
@@ -1293,7 +1303,7 @@ void APP_Update(void)
 
 				// go back to sleep
 
-				g_power_save_10ms = g_eeprom.battery_save * 10;
+				SCHEDULER_StartTimer(TIMER_POWER_SAVE, g_eeprom.battery_save * 10);
 				g_rx_idle_mode    = true;
 
 				BK4819_DisableVox();
@@ -1309,7 +1319,7 @@ void APP_Update(void)
 				DUALWATCH_Alternate();
 
 				g_update_rssi     = true;
-				g_power_save_10ms = power_save1_10ms;
+				SCHEDULER_StartTimer(TIMER_POWER_SAVE, power_save1_10ms);
 			}
 
 			g_power_save_expired = false;
@@ -1320,9 +1330,12 @@ void APP_Update(void)
 // called every 10ms
 void APP_CheckKeys(void)
 {
+	static uint32_t key_down_time;   // when the scanner first saw the last key press
+
 	const bool ptt_pressed = !GPIO_CheckBit(&GPIOC->DATA, GPIOC_PIN_PTT) && (g_serial_config_count_down_500ms == 0) && g_setting_tx_enable;
 
-	key_code_t key;
+	key_code_t  key;
+	key_event_t event;
 
 	#ifdef ENABLE_AIRCOPY
 		if (g_setting_killed ||
@@ -1343,7 +1356,7 @@ void APP_CheckKeys(void)
 			if (++g_ptt_debounce >= 3)      // 30ms
 			{	// start TX'ing
 
-				g_boot_counter_10ms = 0;    // cancel the boot-up screen
+				SCHEDULER_StopTimer(TIMER_BOOT);    // cancel the boot-up screen
 				g_ptt_is_pressed    = true;
 				g_ptt_was_released  = false;
 				g_ptt_debounce      = 0;
@@ -1383,10 +1396,14 @@ void APP_CheckKeys(void)
 	// *****************
 	// button processing (non-PTT)
 
-	// scan the hardware keys
-	key = KEYBOARD_Poll();
+	// scan the hardware keys .. a row a tick
+	KEYBOARD_Scan();
+	while (KEYBOARD_GetEvent(&event))
+		if (event.pressed)
+			key_down_time = event.time_10ms;
+	key = KEYBOARD_GetKey();
 
-	g_boot_counter_10ms = 0;   // cancel boot screen/beeps
+	SCHEDULER_StopTimer(TIMER_BOOT);   // cancel boot screen/beeps
 
 	if (g_serial_config_count_down_500ms > 0)
 	{	// config upload/download in progress
@@ -1416,7 +1433,7 @@ void APP_CheckKeys(void)
 					g_key_debounce_repeat = 0;
 					g_key_prev            = KEY_INVALID;
 					g_key_held            = false;
-					g_boot_counter_10ms   = 0;         // cancel the boot-up screen
+					SCHEDULER_StopTimer(TIMER_BOOT);         // cancel the boot-up screen
 
 					g_update_status       = true;
 					g_update_display      = true;
@@ -1428,26 +1445,28 @@ void APP_CheckKeys(void)
 	}
 	else
 	{	// key pressed
-		if (g_key_debounce_press < key_debounce_10ms)
-		{
-			if (++g_key_debounce_press >= key_debounce_10ms)
-			{
-				if (key != g_key_prev)
-				{	// key now fully pressed
-					g_key_debounce_repeat = key_debounce_10ms;
-					g_key_held            = false;
+		if (g_key_debounce_press == 0)
+		{	// KEYBOARD_Scan() has debounced it already, no need to wait again
+			g_key_debounce_press = 1;
 
-					#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
-						UART_printf("\r\n new key %3u %3u, %3u %3u, %u\r\n", key, g_key_prev, g_key_debounce_press, g_key_debounce_repeat, g_key_held);
-					#endif
+			if (key != g_key_prev)
+			{	// key now fully pressed
+				const uint32_t latency = g_global_sys_tick_counter - key_down_time;
 
-					g_key_prev = key;
+				g_key_latency_10ms    = (latency < 255) ? latency : 255;
+				g_key_debounce_repeat = key_debounce_10ms;
+				g_key_held            = false;
 
-					APP_ProcessKey(g_key_prev, true, g_key_held);
+				#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
+					UART_printf("\r\n new key %3u %3u, %3u %3u, %u\r\n", key, g_key_prev, g_key_debounce_press, g_key_debounce_repeat, g_key_held);
+				#endif
 
-					g_update_status  = true;
-					g_update_display = true;
-				}
+				g_key_prev = key;
+
+				APP_ProcessKey(g_key_prev, true, g_key_held);
+
+				g_update_status  = true;
+				g_update_display = true;
 			}
 		}
 		else
@@ -1495,9 +1514,17 @@ void APP_TimeSlice10ms(void)
 
 	if (UART_IsCommandAvailable())
 	{
+		#ifdef ENABLE_PROFILER
+			const uint32_t start = PROFILER_Stamp();
+		#endif
+
 		__disable_irq();
 		UART_HandleCommand();
 		__enable_irq();
+
+		#ifdef ENABLE_PROFILER
+			PROFILER_Record(PROFILE_UART_COMMAND, start);
+		#endif
 	}
 
 	// ***********
@@ -1572,12 +1599,32 @@ void APP_TimeSlice10ms(void)
 	#ifdef ENABLE_AM_FIX
 //		if (g_eeprom.vfo_info[g_eeprom.rx_vfo].am_mode && g_setting_am_fix)
 		if (g_rx_vfo->am_mode && g_setting_am_fix)
+		{
+			#ifdef ENABLE_PROFILER
+				const uint32_t start = PROFILER_Stamp();
+			#endif
+
 			AM_fix_10ms(g_eeprom.rx_vfo);
+
+			#ifdef ENABLE_PROFILER
+				PROFILER_Record(PROFILE_AM_FIX, start);
+			#endif
+		}
 	#endif
 
 	if (g_current_function != FUNCTION_POWER_SAVE || !g_rx_idle_mode)
+	{
+		#ifdef ENABLE_PROFILER
+			const uint32_t start = PROFILER_Stamp();
+		#endif
+
 		APP_CheckRadioInterrupts();
 
+		#ifdef ENABLE_PROFILER
+			PROFILER_Record(PROFILE_RADIO_INTERRUPTS, start);
+		#endif
+	}
+
 	if (g_current_function == FUNCTION_TRANSMIT)
 	{	// transmitting
 		#ifdef ENABLE_AUDIO_BAR
@@ -1967,6 +2014,8 @@ void APP_TimeSlice500ms(void)
 
 		if (g_usb_current > 500 || g_battery_calibration[3] < g_usb_current_voltage)
 		{
+			EEPROM_Flush();
+
 			#ifdef ENABLE_OVERLAY
 				overlay_FLASH_RebootToBootloader();
 			#else
@@ -2149,6 +2198,8 @@ void APP_TimeSlice500ms(void)
 
 						g_reduced_service = true;
 
+						EEPROM_Flush();   // get the settings in before the battery gives out
+
 						FUNCTION_Select(FUNCTION_POWER_SAVE);
 
 						ST7565_HardwareReset();
@@ -2262,7 +2313,7 @@ void CHANNEL_Next(const bool flag, const scan_state_dir_t scan_direction)
 		FREQ_NextChannel();
 	}
 
-	g_scan_pause_delay_in_10ms = scan_pause_delay_in_2_10ms;
+	SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, scan_pause_delay_in_2_10ms);
 	g_schedule_scan_listen    = false;
 	g_rx_reception_mode       = RX_MODE_NONE;
 	g_scan_pause_mode         = false;
@@ -2299,7 +2350,7 @@ static void APP_ProcessKey(const key_code_t Key, const bool key_pressed, const b
 		FUNCTION_Select(FUNCTION_FOREGROUND);
 
 	// stay awake - for now
-	g_battery_save_count_down_10ms = battery_save_count_10ms;
+	SCHEDULER_StartTimer(TIMER_BATTERY_SAVE, battery_save_count_10ms);
 
 	// keep the auto keylock at bay
 	if (g_eeprom.auto_keypad_lock)
@@ -27,6 +27,7 @@
 #include "driver/uart.h"
 #include "functions.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/inputbox.h"
 #include "ui/ui.h"
@@ -126,7 +127,7 @@ void FM_Tune(uint16_t Frequency, int8_t Step, bool flag)
 
 	g_enable_speaker = false;
 
-	g_fm_play_count_down_10ms = (g_fm_scan_state == FM_SCAN_OFF) ? fm_play_countdown_noscan_10ms : fm_play_countdown_scan_10ms;
+	SCHEDULER_StartTimer(TIMER_FM_PLAY, (g_fm_scan_state == FM_SCAN_OFF) ? fm_play_countdown_noscan_10ms : fm_play_countdown_scan_10ms);
 
 	g_schedule_fm                 = false;
 	g_fm_found_frequency          = false;
@@ -165,7 +166,7 @@ void FM_PlayAndUpdate(void)
 	BK1080_SetFrequency(g_eeprom.fm_frequency_playing);
 	SETTINGS_SaveFM();
 
-	g_fm_play_count_down_10ms = 0;
+	SCHEDULER_StopTimer(TIMER_FM_PLAY);
 	g_schedule_fm             = false;
 	g_ask_to_save             = false;
 
@@ -653,7 +654,7 @@ void FM_Play(void)
 	{
 		if (!g_fm_auto_scan)
 		{
-			g_fm_play_count_down_10ms = 0;
+			SCHEDULER_StopTimer(TIMER_FM_PLAY);
 			g_fm_found_frequency      = true;
 
 			if (!g_eeprom.fm_is_channel_mode)
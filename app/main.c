@@ -31,11 +31,12 @@
 #include "frequencies.h"
 #include "misc.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/inputbox.h"
 #include "ui/ui.h"
 #ifdef ENABLE_SPECTRUM
-//	#include "app/spectrum.h"
+	#include "app/spectrum.h"
 #endif
 
 void toggle_chan_scanlist(void)
@@ -218,6 +219,10 @@ static void processFKeyFunction(const key_code_t Key)
 				g_request_save_vfo   = true;
 				g_vfo_configure_mode = VFO_CONFIGURE_RELOAD;
 
+			#elif defined(ENABLE_SPECTRUM)
+				APP_RunSpectrum();
+				g_flag_reconfigure_vfos  = true;   // the spectrum leaves the BK4819 set up its own way
+				g_request_display_screen = DISPLAY_MAIN;
 			#else
 				#ifdef ENABLE_VOX
 					toggle_chan_scanlist();
@@ -809,7 +814,7 @@ static void MAIN_Key_UP_DOWN(bool key_pressed, bool key_held, scan_state_dir_t D
 
 	// jump to the next channel
 	CHANNEL_Next(false, Direction);
-	g_scan_pause_delay_in_10ms = 1;
+	SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, 1);
 	g_schedule_scan_listen    = false;
 
 //	g_ptt_was_released = true;    // why is this being set ?
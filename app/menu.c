@@ -35,6 +35,7 @@
 #include "frequencies.h"
 #include "helper/battery.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 #if defined(ENABLE_OVERLAY)
 	#include "sram-overlay.h"
@@ -87,7 +88,7 @@ void MENU_StartCssScan(int8_t Direction)
 
 	MENU_SelectNextCode();
 
-	g_scan_pause_delay_in_10ms = scan_pause_delay_in_2_10ms;
+	SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, scan_pause_delay_in_2_10ms);
 	g_schedule_scan_listen     = false;
 }
 
@@ -885,7 +886,7 @@ void MENU_SelectNextCode(void)
 
 	RADIO_SetupRegisters(true);
 
-	g_scan_pause_delay_in_10ms = (g_selected_code_type == CODE_TYPE_CONTINUOUS_TONE) ? scan_pause_delay_in_3_10ms : scan_pause_delay_in_4_10ms;
+	SCHEDULER_StartTimer(TIMER_SCAN_PAUSE, (g_selected_code_type == CODE_TYPE_CONTINUOUS_TONE) ? scan_pause_delay_in_3_10ms : scan_pause_delay_in_4_10ms);
 
 	g_update_display = true;
 }
@@ -1602,6 +1603,8 @@ static void MENU_Key_MENU(const bool key_pressed, const bool key_held)
 
 						MENU_AcceptSetting();
 
+						EEPROM_Flush();
+
 						#if defined(ENABLE_OVERLAY)
 							overlay_FLASH_RebootToBootloader();
 						#else
@@ -14,10 +14,219 @@
  *     limitations under the License.
  */
 
-#include "../app/spectrum.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "app/spectrum.h"
+#include "bitmaps.h"
+#include "board.h"
+#include "bsp/dp32g030/gpio.h"
+#include "driver/bk4819-regs.h"
+#include "driver/bk4819.h"
+#include "driver/eeprom.h"
+#include "driver/gpio.h"
+#include "driver/keyboard.h"
+#include "driver/st7565.h"
+#include "driver/system.h"
+#include "driver/systick.h"
+#include "external/printf/printf.h"
+#include "font.h"
+#include "frequencies.h"
+#include "helper/battery.h"
+#include "misc.h"
+#include "radio.h"
+#include "settings.h"
+#include "ui/helper.h"
+
+static const uint8_t DrawingEndY = 40;
+
+static const uint16_t scanStepValues[] = {
+	1,   10,  50,  100, 250, 500, 625, 833, 1000, 1250, 2500, 10000,
+};
+
+static const uint8_t gStepSettingToIndex[] = {
+#ifdef ENABLE_1250HZ_STEP
+	[STEP_1_25kHz] = 3,
+#else
+	[STEP_5_0kHz]  = 5,
+#endif
+	[STEP_2_5kHz]  = 4, [STEP_6_25kHz] = 6,
+	[STEP_10_0kHz] = 8, [STEP_12_5kHz] = 9, [STEP_25_0kHz] = 10,
+	[STEP_8_33kHz] = 7,
+};
 
-#define F_MIN FrequencyBandTable[0].lower
-#define F_MAX FrequencyBandTable[ARRAY_SIZE(FrequencyBandTable) - 1].upper
+static const uint16_t scanStepBWRegValues[12] = {
+	//     RX  RXw TX  BW
+	// 0b0 000 000 001 01 1000
+	// 1
+	__extension__ 0b0000000001011000, // 6.25
+	// 10
+	__extension__ 0b0000000001011000, // 6.25
+	// 50
+	__extension__ 0b0000000001011000, // 6.25
+	// 100
+	__extension__ 0b0000000001011000, // 6.25
+	// 250
+	__extension__ 0b0000000001011000, // 6.25
+	// 500
+	__extension__ 0b0010010001011000, // 6.25
+	// 625
+	__extension__ 0b0100100001011000, // 6.25
+	// 833
+	__extension__ 0b0110110001001000, // 6.25
+	// 1000
+	__extension__ 0b0110110001001000, // 6.25
+	// 1250
+	__extension__ 0b0111111100001000, // 6.25
+	// 2500
+	__extension__ 0b0011011000101000, // 25
+	// 10000
+	__extension__ 0b0011011000101000, // 25
+};
+
+static const uint16_t listenBWRegValues[] = {
+	__extension__ 0b0011011000101000, // 25
+	__extension__ 0b0111111100001000, // 12.5
+	__extension__ 0b0100100001011000, // 6.25
+};
+
+typedef enum State {
+	SPECTRUM,
+	FREQ_INPUT,
+	STILL,
+} State;
+
+typedef enum ChannelList {
+	CHANNELS_ALL,
+	CHANNELS_SCANLISTS,
+	CHANNELS_SCANLIST1,
+	CHANNELS_SCANLIST2,
+	CHANNELS_LIST_COUNT,
+} ChannelList;
+
+typedef enum StepsCount {
+	STEPS_128,
+	STEPS_64,
+	STEPS_32,
+	STEPS_16,
+} StepsCount;
+
+typedef enum ModulationType {
+	MOD_FM,
+	MOD_AM,
+	MOD_USB,
+} ModulationType;
+
+typedef enum ScanStep {
+	S_STEP_0_01kHz,
+	S_STEP_0_1kHz,
+	S_STEP_0_5kHz,
+	S_STEP_1_0kHz,
+
+	S_STEP_2_5kHz,
+	S_STEP_5_0kHz,
+	S_STEP_6_25kHz,
+	S_STEP_8_33kHz,
+	S_STEP_10_0kHz,
+	S_STEP_12_5kHz,
+	S_STEP_25_0kHz,
+	S_STEP_100_0kHz,
+} ScanStep;
+
+typedef struct SpectrumSettings {
+	StepsCount stepsCount;
+	ScanStep scanStepIndex;
+	uint32_t frequencyChangeStep;
+	uint16_t scanDelay;
+	uint16_t rssiTriggerLevel;
+
+	bool backlightState;
+	BK4819_filter_bandwidth_t bw;
+	BK4819_filter_bandwidth_t listenBw;
+	ModulationType modulationType;
+} SpectrumSettings;
+
+typedef struct KeyboardState {
+	key_code_t current;
+	key_code_t prev;
+	uint8_t counter;
+} KeyboardState;
+
+typedef struct ScanInfo {
+	uint16_t rssi, rssiMin, rssiMax;
+	uint8_t i, iPeak;
+	uint32_t f, fPeak;
+	uint16_t scanStep;
+	uint8_t measurementsCount;
+} ScanInfo;
+
+typedef struct RegisterSpec {
+	const char *name;
+	uint8_t num;
+	uint8_t offset;
+	uint16_t maxValue;
+	uint16_t inc;
+} RegisterSpec;
+
+typedef struct PeakInfo {
+	uint16_t t;
+	uint16_t rssi;
+	uint8_t i;
+	uint32_t f;
+} PeakInfo;
+
+// an entry in the table of signals found over the last few sweeps
+typedef struct ActivePeak {
+	uint32_t f;           // 0 = unused
+	uint16_t rssi;        // as last measured
+	uint16_t lastSeen;    // sweep it was last found in
+	uint8_t  hits;        // sweeps it's been found in
+	uint8_t  i;           // bin
+} ActivePeak;
+
+// per bin statistics, updated as each point is measured rather than from a
+// history of whole sweeps
+typedef struct SpectrumStats {
+	uint16_t mean[128];        // exponential moving average, x4
+	uint16_t hold[128];        // peak hold, decays a little each sweep
+	uint8_t  histogram[64];    // this sweep's means, RSSI / 8
+	uint32_t sum;              // this sweep's means
+	uint8_t  count;            // bins measured this sweep
+	uint16_t sweepMin, sweepMax;
+	bool     primed;           // the means hold something
+	uint16_t min, mid, max;    // last complete sweep
+	uint16_t noiseFloor;       // last complete sweep, NOISE_PERCENTILE of the means
+} SpectrumStats;
+
+typedef struct FreqPreset {
+	char name[16];
+	uint32_t fStart;
+	uint32_t fEnd;
+	StepsCount stepsCountIndex;
+	uint8_t stepSizeIndex;
+	ModulationType modulationType;
+	BK4819_filter_bandwidth_t listenBW;
+} FreqPreset;
+
+static const FreqPreset freqPresets[] = {
+	{"17m",         1806800,  1831800, STEPS_128, S_STEP_1_0kHz,   MOD_USB, BK4819_FILTER_BW_NARROWER},
+	{"15m",         2100000,  2145000, STEPS_128, S_STEP_1_0kHz,   MOD_USB, BK4819_FILTER_BW_NARROWER},
+	{"12m",         2489000,  2514000, STEPS_128, S_STEP_1_0kHz,   MOD_USB, BK4819_FILTER_BW_NARROWER},
+	{"CB",          2697500,  2785500, STEPS_128, S_STEP_5_0kHz,   MOD_FM,  BK4819_FILTER_BW_NARROW  },
+	{"10m",         2800000,  2970000, STEPS_128, S_STEP_1_0kHz,   MOD_USB, BK4819_FILTER_BW_NARROWER},
+	{"AIR",        11800000, 13500000, STEPS_128, S_STEP_100_0kHz, MOD_AM,  BK4819_FILTER_BW_NARROW  },
+	{"2m",         14400000, 14600000, STEPS_128, S_STEP_25_0kHz,  MOD_FM,  BK4819_FILTER_BW_NARROW  },
+	{"JD1",        15175000, 15400000, STEPS_128, S_STEP_25_0kHz,  MOD_FM,  BK4819_FILTER_BW_NARROW  },
+	{"JD2",        15500000, 15600000, STEPS_64,  S_STEP_25_0kHz,  MOD_FM,  BK4819_FILTER_BW_NARROW  },
+	{"LPD",        43307500, 43477500, STEPS_128, S_STEP_25_0kHz,  MOD_FM,  BK4819_FILTER_BW_WIDE    },
+	{"PMR",        44600625, 44620000, STEPS_16,  S_STEP_12_5kHz,  MOD_FM,  BK4819_FILTER_BW_NARROW  },
+	{"FRS/GM 462", 46256250, 46272500, STEPS_16,  S_STEP_12_5kHz,  MOD_FM,  BK4819_FILTER_BW_NARROW  },
+	{"FRS/GM 467", 46756250, 46771250, STEPS_16,  S_STEP_12_5kHz,  MOD_FM,  BK4819_FILTER_BW_NARROW  },
+};
+
+#define F_MIN FREQ_BAND_TABLE[0].lower
+#define F_MAX FREQ_BAND_TABLE[ARRAY_SIZE(FREQ_BAND_TABLE) - 1].upper
 
 const uint16_t RSSI_MAX_VALUE = 65535;
 
@@ -62,16 +271,43 @@ uint32_t fTx              = 0;
 uint32_t currentFreq;
 uint32_t tempFreq;
 uint16_t rssiHistory[128] = {0};
-bool     blacklist[128]   = {false};
+
+// blacklist .. frequencies kept sorted in EEPROM, erased entries (0xFFFFFFFF)
+// at the end, and mapped onto the bins of the view whenever it changes .. the
+// region's only trusted once it's been stamped with BLACKLIST_MAGIC
+#define BLACKLIST_HEADER 0x1D00       // past the DTMF contacts, kept by a factory reset
+#define BLACKLIST_MAGIC  0x424C0001   // "BL", layout version 1
+#define BLACKLIST_EEPROM 0x1D08
+#define BLACKLIST_MAX    32           // 128 bytes
+
+static uint8_t blacklist[128 / 8];   // the view's bins with an entry in them
+
+// channels .. a bar a memory channel rather than a bin a step, the frequencies
+// are read in when the list's picked so the sweep never waits on I2C .. the
+// scan lists' are in the radio's channel index already, the all channels list
+// keeps its own in place of the waterfall rows (see below)
+#define CHANNELS_MAX 128
+
+static const char *channelListOptions[] = {"ALL", "SL", "SL1", "SL2"};
+
+static bool     channelMode;
+static uint8_t  channelList;               // ChannelList
+static uint8_t  channelCount;
+static bool     channelsTruncated;         // there were more than were shown
+static uint8_t  channelNum[CHANNELS_MAX];
+static char     channelName[11];           // the peak's, read when it changes
+static uint8_t  channelNameNum = 0xFF;
 
 static const RegisterSpec afOutRegSpec     = {"AF OUT", 0x47, 8, 0xF, 1};
 static const RegisterSpec afDacGainRegSpec = {"AF DAC G", 0x48, 0, 0xF, 1};
+static const RegisterSpec afOutEnRegSpec   = {"AF EN", 0x47, 8, 1, 1};
+static const RegisterSpec afDacEnRegSpec   = {"AF DAC EN", 0x30, 9, 1, 1};
 static const RegisterSpec registerSpecs[]  = {
-	{},
-	{"LNAs", 0x13, 8, 0b11,  1},
-	{"LNA",  0x13, 5, 0b111, 1},
-	{"PGA",  0x13, 0, 0b111, 1},
-	{"MIX",  0x13, 3, 0b11,  1},
+	{NULL, 0, 0, 0, 0},
+	{"LNAs", 0x13, 8, __extension__ 0b11,  1},
+	{"LNA",  0x13, 5, __extension__ 0b111, 1},
+	{"PGA",  0x13, 0, __extension__ 0b111, 1},
+	{"MIX",  0x13, 3, __extension__ 0b11,  1},
 	{"DEV",  0x40, 0, 4095,  1},
 	{"CMP",  0x31, 3, 1,     1},
 	{"MIC",  0x7D, 0, 0x1F,  1},
@@ -82,8 +318,61 @@ static const uint8_t registersToBackup[] = {
 	0x13, 0x30, 0x31, 0x37, 0x3D, 0x40, 0x43, 0x47, 0x48, 0x7D, 0x7E,
 };
 
-static MovingAverage mov   = {{128}, {}, 255, 128, 0, 0};
-static const uint8_t MOV_N = ARRAY_SIZE(mov.buf);
+static SpectrumStats stats = {.min = 255, .mid = 128};
+
+static const uint8_t MEAN_SHIFT       = 2;    // EMA weight 1/4, about the old 4 sweep average
+static const uint8_t HOLD_DECAY       = 1;    // RSSI units (0.5dB) per sweep
+static const uint8_t NOISE_PERCENTILE = 20;
+static const uint8_t TRIGGER_OVER_NF  = 20;   // RSSI units (0.5dB) the automatic trigger sits above the noise floor
+
+static bool autoTrigger;                      // follow the noise floor till a level's set by hand
+
+// waterfall .. a row per sweep, 2 bits a column (level over the noise floor),
+// drawn dithered into WATERFALL_LINE onwards and scrolled down a row per sweep
+#define WATERFALL_ROWS 32
+#define WATERFALL_LINE 2
+
+static const uint8_t WATERFALL_STEP = 12;     // RSSI units (0.5dB) a level
+
+// there's no waterfall in channel mode, the all channels list's frequencies
+// go in its rows .. they're reset on the way out of it
+static union {
+  uint8_t  waterfall[WATERFALL_ROWS][128 / 4];
+  uint32_t channelF[CHANNELS_MAX];
+} shared;
+static uint8_t waterfallHead;                 // newest row
+static uint8_t waterfallCount;                // rows added, for the dither phase
+static bool    waterfallMode;
+static bool    waterfallRedraw = true;        // the frame buffer doesn't hold the waterfall
+static bool    waterfallScroll;               // a new row's waiting to be scrolled in
+
+static void ResetWaterfall();
+
+// coarse cache .. the widest recent sweep, kept by frequency, so a zoom or a
+// pan draws what's already known straight away while the sweep refines it
+static const uint8_t REFINE_REDRAW_BINS = 16;   // drawn this often while a view's being refined
+
+static uint16_t coarse[128];
+static uint32_t coarseStart;
+static uint16_t coarseStep;
+static uint8_t  coarseCount;                    // 0 = empty
+static uint8_t  refined[128 / 8];               // bins measured since the view changed, the rest are from the cache
+static bool     refining;                       // the first sweep of a view that was drawn from the cache
+
+// peaks .. the strongest few local maxima of each sweep, kept in a small table
+// across sweeps that the listener works through once after each sweep
+#define PEAKS_MAX 6
+
+static const uint8_t  PEAK_PROMINENCE = 10;     // RSSI units (0.5dB) a peak stands over the dips either side of it
+static const uint8_t  PEAK_WINDOW     = 4;      // bins either side the dips are looked for in
+static const uint8_t  PEAK_EXPIRE     = 8;      // sweeps a peak's kept after it was last found
+static const uint16_t PEAK_DWELL      = 1000;   // listenT ticks (about 1ms) on a peak before moving on
+static const uint16_t PEAK_CHECK      = 50;     // listenT ticks before a peak's checked it's still there
+
+static ActivePeak peaks[PEAKS_MAX];
+static uint8_t    peakCurrent = PEAKS_MAX;      // the one being listened to, PEAKS_MAX for none
+static bool       peakChecking;                 // it's only been given PEAK_CHECK so far
+static uint16_t   peakSweep;                    // sweeps done, for lastSeen
 
 const uint8_t FREQ_INPUT_LENGTH = 10;
 uint8_t       freqInputIndex    = 0;
@@ -95,9 +384,39 @@ uint8_t  menuState = 0;
 
 uint16_t listenT   = 0;
 
+#define CLOCKS_PER_US (SYSTICK_CLOCKS_PER_TICK / 10000u)
+
+// SPECTRUM_ADAPTIVE_DWELL measures the dwell on a carrier rather than using the
+// old fixed delay, and reads the points well under the trigger early .. it's yet
+// to be checked against real signals on a radio, so it's not built by default
+static const uint16_t SETTLE_MAX_US  = 3200;   // the old fixed delay
+#ifdef SPECTRUM_ADAPTIVE_DWELL
+static const uint16_t SETTLE_MIN_US    = 400;
+static const uint16_t SETTLE_POLL_US   = 100;
+static const uint16_t SETTLE_CONTRAST  = 40;   // RSSI units (0.5dB) between the bins it's measured on
+static const uint16_t SETTLE_TOLERANCE = 2;    // RSSI units (0.5dB) from where it ends up that's settled
+static const uint16_t DWELL_MARGIN     = 20;   // RSSI units (0.5dB) under the trigger for a short dwell
+
+static uint16_t settleUs[ARRAY_SIZE(scanStepValues)];   // 0 = not measured yet
+#endif
+static uint32_t tunedAt;                                // SYSTICK_GetClocks() when the pending point was tuned
+static bool     tunePending;
+static uint8_t  sweepStart;                             // the sweep's first bin, and the one after its last ..
+static uint8_t  sweepEnd;                               // short of the whole span in fast find
+
+// fast find .. the chip's frequency scan counts the strongest carrier at the
+// antenna in 0.2s however wide the span, so the RSSI sweep only has to look
+// either side of what it finds rather than at every bin
+static const uint8_t FAST_FIND_BINS    = 8;     // swept either side of a carrier
+static const uint8_t FAST_FIND_HITS    = 1;     // repeats within 1kHz before a carrier's believed
+static const uint8_t FAST_FIND_POLL_MS = 10;
+
+static bool     fastFind;
+static bool     carrierCounting;                // the chip's frequency scan is running
+static uint32_t carrierF;
+static uint8_t  carrierHits;
+
 uint16_t batteryUpdateTimer  = 0;
-bool     isMovingInitialized = false;
-uint8_t  lastStepsCount      = 0;
 
 uint8_t CountBits(uint16_t n)
 {
@@ -141,11 +460,82 @@ static void UpdateRegMenuValue(RegisterSpec s, bool add)
 	redrawScreen = true;
 }
 
+static void ToggleAFBit(bool on)
+{
+	SetRegValue(afOutEnRegSpec, on);
+}
+
+static void ToggleAFDAC(bool on)
+{
+	SetRegValue(afDacEnRegSpec, on);
+}
+
 // Utility functions
 
+static int32_t Clamp(int32_t v, int32_t min, int32_t max)
+{
+	return (v <= min) ? min : (v >= max) ? max : v;
+}
+
+// v's place between aMin and aMax scaled to between bMin and bMax
+static int32_t ConvertDomain(int32_t v, int32_t aMin, int32_t aMax, int32_t bMin, int32_t bMax)
+{
+	const int32_t aRange = aMax - aMin;
+	const int32_t bRange = bMax - bMin;
+
+	if (aRange <= 0)
+		return bMin;
+
+	v = Clamp(v, aMin, aMax);
+	return (((v - aMin) * bRange) + (aRange / 2)) / aRange + bMin;
+}
+
+static uint16_t Mid(const uint16_t *array, uint8_t n)
+{
+	uint32_t sum = 0;
+	for (uint8_t i = 0; i < n; ++i)
+		sum += array[i];
+	return sum / n;
+}
+
+static int Rssi2DBm(uint16_t rssi)
+{
+	return (rssi / 2) - 160;
+}
+
+// S9 is -73dBm, an S unit's 6dB below it, 10dB steps (S9+10 etc) above it
+static uint8_t DBm2S(int dbm)
+{
+	if (dbm < -73)
+		return Clamp((dbm + 127) / 6, 0, 8);
+	return 9 + Clamp((dbm + 73) / 10, 0, 6);
+}
+
+static uint8_t Rssi2PX(uint16_t rssi, uint8_t pxMin, uint8_t pxMax)
+{
+	return ConvertDomain(Rssi2DBm(rssi), -130, -50, pxMin, pxMax);
+}
+
+static void PutPixel(uint8_t x, uint8_t y, bool fill)
+{
+	if (x >= ARRAY_SIZE(g_frame_buffer[0]) || y >= ARRAY_SIZE(g_frame_buffer) * 8)
+		return;
+	if (fill)
+		g_frame_buffer[y >> 3][x] |=   1u << (y & 7);
+	else
+		g_frame_buffer[y >> 3][x] &= ~(1u << (y & 7));
+}
+
+static void DrawVLine(uint8_t sy, uint8_t ey, uint8_t x, bool fill)
+{
+	for (uint8_t y = sy; y <= ey; ++y)
+		PutPixel(x, y, fill);
+}
+
 key_code_t GetKey()
 {
-	key_code_t btn = KEYBOARD_Poll();
+	KEYBOARD_Scan();   // a row a tick, however fast we spin
+	key_code_t btn = KEYBOARD_GetKey();
 	if (btn == KEY_INVALID && !GPIO_CheckBit(&GPIOC->DATA, GPIOC_PIN_PTT))
 		btn = KEY_PTT;
 	return btn;
@@ -163,7 +553,7 @@ void SetState(State state)
 
 static void BackupRegisters()
 {
-	for (int i = 0; i < ARRAY_SIZE(registersToBackup); ++i)
+	for (unsigned int i = 0; i < ARRAY_SIZE(registersToBackup); ++i)
 	{
 		uint8_t regNum = registersToBackup[i];
 		registersBackup[regNum] = BK4819_ReadRegister(regNum);
@@ -172,7 +562,7 @@ static void BackupRegisters()
 
 static void RestoreRegisters()
 {
-	for (int i = 0; i < ARRAY_SIZE(registersToBackup); ++i)
+	for (unsigned int i = 0; i < ARRAY_SIZE(registersToBackup); ++i)
 	{
 		uint8_t regNum = registersToBackup[i];
 		BK4819_WriteRegister(regNum, registersBackup[regNum]);
@@ -190,9 +580,9 @@ static void SetModulation(ModulationType type)
 	
 	if (type == MOD_USB)
 	{
-		BK4819_WriteRegister(0x37, 0b0001011000001111);
-		BK4819_WriteRegister(0x3D, 0b0010101101000101);
-		BK4819_WriteRegister(0x48, 0b0000001110101000);
+		BK4819_WriteRegister(0x37, __extension__ 0b0001011000001111);
+		BK4819_WriteRegister(0x3D, __extension__ 0b0010101101000101);
+		BK4819_WriteRegister(0x48, __extension__ 0b0000001110101000);
 	}
 	
 	if (type == MOD_AM)
@@ -235,63 +625,426 @@ uint32_t GetFStart() {
   return IsCenterMode() ? currentFreq - (GetBW() >> 1) : currentFreq;
 }
 uint32_t GetFEnd() { return currentFreq + GetBW(); }
+uint32_t GetChannelF(uint8_t i) {
+  if (channelList == CHANNELS_ALL) {
+    return shared.channelF[i];
+  }
+  uint32_t f = 0;
+  RADIO_GetIndexedFrequency(channelNum[i], &f);
+  return f;
+}
+uint32_t GetBinF(uint8_t i) {
+  return channelMode ? GetChannelF(i) : GetFStart() + i * GetScanStep();
+}
+
+// Statistics
 
-static void MovingCp(uint16_t *dst, uint16_t *src) {
-  memcpy(dst, src, GetStepsCount() * sizeof(uint16_t));
+static void ResetSweepStats() {
+  memset(stats.histogram, 0, sizeof(stats.histogram));
+  stats.sum = 0;
+  stats.count = 0;
+  stats.sweepMin = RSSI_MAX_VALUE;
+  stats.sweepMax = 0;
 }
 
-static void ResetMoving() {
-  for (int i = 0; i < MOV_N; ++i) {
-    MovingCp(mov.buf[i], rssiHistory);
-  }
+static void ResetStats() {
+  memset(stats.hold, 0, sizeof(stats.hold));
+  stats.primed = false;
+  ResetSweepStats();
 }
 
-static void MoveHistory() {
-  const uint8_t XN = GetStepsCount();
+// O(1) per point, called as each one's measured
+static void UpdateStats(uint8_t i, uint16_t rssi) {
+  if (!stats.primed) {
+    stats.mean[i] = rssi << MEAN_SHIFT;
+  } else {
+    stats.mean[i] += rssi - (stats.mean[i] >> MEAN_SHIFT);
+  }
 
-  uint32_t midSum = 0;
+  const uint16_t mean = stats.mean[i] >> MEAN_SHIFT;
 
-  mov.min = RSSI_MAX_VALUE;
-  mov.max = 0;
+  stats.sum += mean;
+  stats.count++;
+  stats.histogram[Clamp(mean >> 3, 0, ARRAY_SIZE(stats.histogram) - 1)]++;
 
-  if (lastStepsCount != XN) {
-    ResetMoving();
-    lastStepsCount = XN;
+  if (mean < stats.sweepMin) {
+    stats.sweepMin = mean;
   }
-  for (int i = MOV_N - 1; i > 0; --i) {
-    MovingCp(mov.buf[i], mov.buf[i - 1]);
+  if (mean > stats.sweepMax) {
+    stats.sweepMax = mean;
   }
-  MovingCp(mov.buf[0], rssiHistory);
 
-  uint8_t skipped = 0;
+  uint16_t hold = stats.hold[i] > HOLD_DECAY ? stats.hold[i] - HOLD_DECAY : 0;
+  stats.hold[i] = hold < rssi ? rssi : hold;
+}
 
-  for (int x = 0; x < XN; ++x) {
-    if (blacklist[x]) {
-      skipped++;
-      continue;
+// end of a whole sweep, publish what it found
+static void FinishStats() {
+  if (stats.count == 0) {
+    return;
+  }
+
+  stats.min = stats.sweepMin;
+  stats.max = stats.sweepMax;
+  stats.mid = stats.sum / stats.count;
+
+  // the noise floor is a low percentile of the bins rather than the mean,
+  // which a few strong carriers would drag up
+  const uint16_t target = (stats.count * NOISE_PERCENTILE + 99) / 100;
+  uint16_t seen = 0;
+  for (uint8_t b = 0; b < ARRAY_SIZE(stats.histogram); ++b) {
+    seen += stats.histogram[b];
+    if (seen >= target) {
+      stats.noiseFloor = (b << 3) + 4;
+      break;
     }
-    uint32_t sum = 0;
-    for (int i = 0; i < MOV_N; ++i) {
-      sum += mov.buf[i][x];
+  }
+
+  stats.primed = true;
+  ResetSweepStats();
+}
+
+// Blacklist
+
+static bool IsBlacklisted(uint8_t i) { return (blacklist[i >> 3] >> (i & 7)) & 1u; }
+
+// the channels aren't in frequency order, each one's looked up in the list
+static void MapBlacklistChannels() {
+  const uint16_t half = GetScanStep() >> 1;
+
+  uint32_t list[BLACKLIST_MAX];
+  EEPROM_ReadBuffer(BLACKLIST_EEPROM, list, sizeof(list));
+
+  for (uint8_t i = 0; i < channelCount; ++i) {
+    const uint32_t f = GetChannelF(i);
+    for (uint8_t k = 0; k < BLACKLIST_MAX && list[k] <= f + half; ++k) {
+      if (list[k] + half >= f) {
+        blacklist[i >> 3] |= 1u << (i & 7);
+        break;
+      }
     }
+  }
+}
+
+// the bin whose half a step either side takes in f is blacklisted, the list's
+// sorted so it's O(bins + entries below the view's end)
+static void MapBlacklist() {
+  const uint16_t step = GetScanStep();
+  const uint8_t count = GetStepsCount();
+  const uint32_t lo = GetFStart() - (step >> 1);
+  const uint32_t hi = lo + count * step;
 
-    uint16_t pointV = mov.mean[x] = sum / MOV_N;
+  memset(blacklist, 0, sizeof(blacklist));
 
-    midSum += pointV;
+  if (channelMode) {
+    MapBlacklistChannels();
+    return;
+  }
 
-    if (pointV > mov.max) {
-      mov.max = pointV;
+  for (uint8_t k = 0; k < BLACKLIST_MAX; k += 2) {
+    uint32_t entries[2];
+    EEPROM_ReadBuffer(BLACKLIST_EEPROM + (k * 4), entries, sizeof(entries));
+    for (uint8_t n = 0; n < 2; ++n) {
+      if (entries[n] >= hi) {
+        return;   // past the view, or the end of the list
+      }
+      if (entries[n] >= lo) {
+        const uint8_t i = (entries[n] - lo) / step;
+        blacklist[i >> 3] |= 1u << (i & 7);
+      }
     }
+  }
+}
+
+// rewrites the list from the first entry that's changed
+static void WriteBlacklist(const uint32_t *list, uint8_t from) {
+  from &= ~1u;
+  EEPROM_Write(BLACKLIST_EEPROM + (from * 4), &list[from],
+               (BLACKLIST_MAX - from) * 4);
+}
+
+// the region holds whatever was there before the blacklist, or an older
+// layout of it, till it's formatted .. the list's erased before the header's
+// stamped, so a power cut part way through just formats it again
+static void FormatBlacklist() {
+  uint32_t header[2];
+  EEPROM_ReadBuffer(BLACKLIST_HEADER, header, sizeof(header));
+  if (header[0] == BLACKLIST_MAGIC) {
+    return;
+  }
+
+  uint32_t list[BLACKLIST_MAX];
+  memset(list, 0xFF, sizeof(list));
+  WriteBlacklist(list, 0);
+
+  header[0] = BLACKLIST_MAGIC;
+  header[1] = 0xFFFFFFFF;
+  EEPROM_Write(BLACKLIST_HEADER, header, sizeof(header));
+}
+
+static void AddToBlacklist(uint32_t f) {
+  uint32_t list[BLACKLIST_MAX];
+  EEPROM_ReadBuffer(BLACKLIST_EEPROM, list, sizeof(list));
+
+  uint8_t n = 0;
+  while (n < BLACKLIST_MAX && list[n] < f) {
+    n++;
+  }
+  if (n == BLACKLIST_MAX || list[n] == f || list[BLACKLIST_MAX - 1] != 0xFFFFFFFF) {
+    return;   // already there, or the list's full
+  }
+
+  memmove(&list[n + 1], &list[n], (BLACKLIST_MAX - 1 - n) * sizeof(list[0]));
+  list[n] = f;
+  WriteBlacklist(list, n);
+}
 
-    if (pointV < mov.min) {
-      mov.min = pointV;
+// whether f's within half a step of one of the channels shown
+static bool IsChannelInView(uint32_t f, uint16_t half) {
+  for (uint8_t i = 0; i < channelCount; ++i) {
+    const uint32_t chF = GetChannelF(i);
+    if (f + half >= chF && f <= chF + half) {
+      return true;
     }
   }
-  if (skipped == XN) {
+  return false;
+}
+
+// forgets the entries within the view .. the span of it, or in channel mode
+// the entries MapBlacklistChannels matched to the channels shown
+static void ClearBlacklistInView() {
+  const uint16_t step = GetScanStep();
+  const uint16_t half = step >> 1;
+  const uint32_t lo = GetFStart() - half;
+  const uint32_t hi = lo + GetStepsCount() * step;
+
+  uint32_t list[BLACKLIST_MAX];
+  EEPROM_ReadBuffer(BLACKLIST_EEPROM, list, sizeof(list));
+
+  // the entries kept are packed down over the ones dropped
+  uint8_t from = BLACKLIST_MAX;
+  uint8_t n = 0;
+  for (uint8_t k = 0; k < BLACKLIST_MAX && list[k] != 0xFFFFFFFF; ++k) {
+    const bool inView = channelMode ? IsChannelInView(list[k], half)
+                                    : list[k] >= lo && list[k] < hi;
+    if (!inView) {
+      list[n++] = list[k];
+    } else if (from == BLACKLIST_MAX) {
+      from = k;
+    }
+  }
+  if (from == BLACKLIST_MAX) {
     return;
   }
 
-  mov.mid = midSum / (XN - skipped);
+  memset(&list[n], 0xFF, (BLACKLIST_MAX - n) * sizeof(list[0]));
+  WriteBlacklist(list, from);
+}
+
+// Coarse cache
+
+static void MarkRefined(uint8_t i) { refined[i >> 3] |= 1u << (i & 7); }
+static bool IsRefined(uint8_t i) { return (refined[i >> 3] >> (i & 7)) & 1u; }
+
+static uint16_t GetCoarseRssi(uint32_t f) {
+  if (coarseCount == 0 || f < coarseStart) {
+    return 0;
+  }
+  const uint32_t j = (f - coarseStart) / coarseStep;
+  return j < coarseCount ? coarse[j] : 0;
+}
+
+// fills a new view from the cache rather than blanking it, O(bins)
+static void PrefillFromCoarse() {
+  if (channelMode) {
+    memset(rssiHistory, 0, sizeof(rssiHistory));
+    refining = false;
+    return;
+  }
+
+  const uint32_t fStart = GetFStart();
+  const uint16_t step = GetScanStep();
+  const uint8_t count = GetStepsCount();
+
+  memset(refined, 0, sizeof(refined));
+  refining = false;
+
+  for (uint8_t i = 0; i < count; ++i) {
+    rssiHistory[i] = GetCoarseRssi(fStart + i * step);
+    if (rssiHistory[i] != 0) {
+      refining = true;
+    }
+  }
+}
+
+// end of a sweep .. a wider one replaces the cache, a narrower one is folded
+// into the cache bins it falls in, each taking the strongest of its bins
+static void UpdateCoarse() {
+  if (channelMode) {
+    return;
+  }
+
+  const uint32_t fStart = GetFStart();
+  const uint16_t step = scanInfo.scanStep;
+  const uint8_t count = scanInfo.measurementsCount;
+  const uint32_t span = count * step;
+  const uint32_t coarseEnd = coarseStart + coarseCount * coarseStep;
+
+  refining = false;
+
+  if (coarseCount == 0 || fStart >= coarseEnd || fStart + span <= coarseStart ||
+      span >= coarseCount * coarseStep) {
+    if (sweepStart != 0 || sweepEnd != count) {
+      return;   // a fast find window, not a whole view
+    }
+    memcpy(coarse, rssiHistory, count * sizeof(coarse[0]));
+    coarseStart = fStart;
+    coarseStep = step;
+    coarseCount = count;
+    return;
+  }
+
+  for (uint8_t pass = 0; pass < 2; ++pass) {
+    for (uint8_t i = sweepStart; i < sweepEnd; ++i) {
+      const uint32_t f = fStart + i * step;
+      if (IsBlacklisted(i) || f < coarseStart || f >= coarseEnd) {
+        continue;
+      }
+      uint16_t *c = &coarse[(f - coarseStart) / coarseStep];
+      if (pass == 0) {
+        *c = 0;
+      } else if (*c < rssiHistory[i]) {
+        *c = rssiHistory[i];
+      }
+    }
+  }
+}
+
+// Peaks
+
+static void ResetPeaks() {
+  memset(peaks, 0, sizeof(peaks));
+  peakCurrent = PEAKS_MAX;
+  peakChecking = false;
+}
+
+static uint16_t GetBinRssi(int16_t i) {
+  if (i < sweepStart || i >= sweepEnd || IsBlacklisted(i)) {
+    return 0;
+  }
+  return rssiHistory[i];
+}
+
+// a local maximum that stands PEAK_PROMINENCE over the lowest point within
+// PEAK_WINDOW bins on both sides
+static bool IsProminent(int16_t i, uint16_t rssi) {
+  if (rssi <= GetBinRssi(i - 1) || rssi < GetBinRssi(i + 1)) {
+    return false;
+  }
+
+  uint16_t dipL = rssi;
+  uint16_t dipR = rssi;
+  for (uint8_t d = 1; d <= PEAK_WINDOW; ++d) {
+    const uint16_t l = GetBinRssi(i - d);
+    const uint16_t r = GetBinRssi(i + d);
+    if (l < dipL) {
+      dipL = l;
+    }
+    if (r < dipR) {
+      dipR = r;
+    }
+  }
+  return rssi - (dipL > dipR ? dipL : dipR) >= PEAK_PROMINENCE;
+}
+
+// bins over the trigger level, strongest first .. channels are unrelated to
+// their neighbours, so any of them over it will do
+static uint8_t FindPeaks(uint8_t *found) {
+  uint8_t count = 0;
+
+  for (int16_t i = sweepStart; i < sweepEnd; ++i) {
+    const uint16_t rssi = GetBinRssi(i);
+    if (rssi < settings.rssiTriggerLevel ||
+        (!channelMode && !IsProminent(i, rssi))) {
+      continue;
+    }
+
+    uint8_t n = count;
+    for (; n > 0 && GetBinRssi(found[n - 1]) < rssi; --n) {
+      if (n < PEAKS_MAX) {
+        found[n] = found[n - 1];
+      }
+    }
+    if (n < PEAKS_MAX) {
+      found[n] = i;
+      if (count < PEAKS_MAX) {
+        count++;
+      }
+    }
+  }
+
+  return count;
+}
+
+// the entry for a signal a bin or so from f, or else a free one or the one
+// not found for longest, or NULL when they were all found this sweep
+static ActivePeak *GetPeakEntry(uint32_t f) {
+  ActivePeak *unused = NULL;
+  ActivePeak *oldest = NULL;
+
+  for (uint8_t k = 0; k < PEAKS_MAX; ++k) {
+    ActivePeak *p = &peaks[k];
+    if (p->f == 0) {
+      unused = p;
+    } else if ((p->f > f ? p->f - f : f - p->f) <= (channelMode ? 0 : scanInfo.scanStep)) {
+      return p;
+    } else if (p->lastSeen != peakSweep &&
+               (oldest == NULL || (uint16_t)(peakSweep - p->lastSeen) >
+                                      (uint16_t)(peakSweep - oldest->lastSeen))) {
+      oldest = p;
+    }
+  }
+
+  ActivePeak *p = unused != NULL ? unused : oldest;
+  if (p != NULL) {
+    p->hits = 0;
+  }
+  return p;
+}
+
+// once a sweep, O(bins * PEAK_WINDOW)
+static void UpdatePeakTable() {
+  uint8_t found[PEAKS_MAX];
+  const uint8_t count = FindPeaks(found);
+
+  ++peakSweep;
+
+  for (uint8_t n = 0; n < count; ++n) {
+    const uint32_t f = GetBinF(found[n]);
+    ActivePeak *p = GetPeakEntry(f);
+    if (p == NULL) {
+      break;   // the table's full of stronger ones found this sweep
+    }
+    p->f = f;
+    p->i = found[n];
+    p->rssi = rssiHistory[found[n]];
+    p->lastSeen = peakSweep;
+    if (p->hits < 255) {
+      p->hits++;
+    }
+  }
+
+  for (uint8_t k = 0; k < PEAKS_MAX; ++k) {
+    ActivePeak *p = &peaks[k];
+    if (p->f == 0 || p->lastSeen == peakSweep) {
+      continue;
+    }
+    if ((uint16_t)(peakSweep - p->lastSeen) > PEAK_EXPIRE) {
+      p->f = 0;
+    } else {
+      p->rssi = GetBinRssi(p->i);   // quiet, or at least not a peak, this sweep
+    }
+  }
 }
 
 static void TuneToPeak() {
@@ -301,12 +1054,12 @@ static void TuneToPeak() {
   SetF(scanInfo.f);
 }
 
-uint8_t GetBWRegValueForScan() {
+uint16_t GetBWRegValueForScan() {
   return scanStepBWRegValues[settings.scanStepIndex == S_STEP_100_0kHz ? 11
                                                                        : 0];
 }
 
-uint8_t GetBWRegValueForListen() {
+uint16_t GetBWRegValueForListen() {
   return listenBWRegValues[settings.listenBw];
 }
 
@@ -321,28 +1074,146 @@ static void ResetRSSI() {
 uint16_t GetRssi() {
   if (currentState == SPECTRUM) {
     ResetRSSI();
-    SYSTICK_DelayUs(3200);
+    SYSTICK_DelayUs(SETTLE_MAX_US);
+  }
+  return BK4819_GetRSSI();
+}
+
+// Sweep engine
+//
+// there's only the one receiver, so a point can't be settling while the
+// next is tuned .. instead the next point is tuned the moment the current
+// one's RSSI is latched, and everything else a Tick does (stats, keys,
+// drawing) runs while it settles, the wait is only for what's left over
+
+static void TunePoint(uint32_t f) {
+  SetF(f);   // restarting the RX chain restarts the RSSI too, no ResetRSSI()
+  tunedAt = SYSTICK_GetClocks();
+  tunePending = true;
+}
+
+static void WaitSinceTuned(uint16_t us) {
+  while (SYSTICK_GetClocks() - tunedAt < us * CLOCKS_PER_US) {
+  }
+}
+
+#ifdef SPECTRUM_ADAPTIVE_DWELL
+// the settle time depends on the step (the PLL jump) and the scan bandwidth,
+// which is picked by the step, so it's measured once per step size at the end
+// of a whole sweep .. stepping between its strongest and weakest bins, timing
+// how long the RSSI takes to get to where it is after the old fixed delay. In
+// a quiet band there's no change in level to time, it waits for a carrier
+static void MeasureSettleTime() {
+  if (channelMode || settleUs[settings.scanStepIndex]) {
+    return;
+  }
+
+  uint8_t bins[2] = {0xFF, 0xFF};   // the weakest, the strongest
+  for (uint8_t i = 0; i < scanInfo.measurementsCount; ++i) {
+    if (IsBlacklisted(i)) {
+      continue;
+    }
+    if (bins[0] == 0xFF) {
+      bins[0] = bins[1] = i;
+    }
+    if (rssiHistory[i] < rssiHistory[bins[0]]) {
+      bins[0] = i;
+    }
+    if (rssiHistory[i] > rssiHistory[bins[1]]) {
+      bins[1] = i;
+    }
+  }
+  if (bins[0] == 0xFF || rssiHistory[bins[1]] < rssiHistory[bins[0]] + SETTLE_CONTRAST) {
+    return;
+  }
+
+  uint16_t level[2];
+  for (uint8_t k = 0; k < 2; ++k) {
+    TunePoint(GetBinF(bins[k]));
+    WaitSinceTuned(SETTLE_MAX_US);
+    level[k] = BK4819_GetRSSI();
+  }
+  tunePending = false;
+  if (level[1] < level[0] + SETTLE_CONTRAST) {
+    return;   // it's gone
+  }
+
+  // off the carrier and back on it a couple of times
+  uint16_t worst = 0;
+  for (uint8_t n = 0; n < 4; ++n) {
+    const uint8_t k = n & 1;
+    uint16_t t;
+
+    TunePoint(GetBinF(bins[k]));
+    for (t = SETTLE_POLL_US; t < SETTLE_MAX_US; t += SETTLE_POLL_US) {
+      WaitSinceTuned(t);
+      const uint16_t rssi = BK4819_GetRSSI();
+      if (rssi + SETTLE_TOLERANCE >= level[k] && rssi <= level[k] + SETTLE_TOLERANCE) {
+        break;
+      }
+    }
+
+    if (worst < t) {
+      worst = t;
+    }
+  }
+  tunePending = false;
+
+  settleUs[settings.scanStepIndex] = Clamp(worst + (worst >> 2), SETTLE_MIN_US, SETTLE_MAX_US);
+}
+#endif
+
+// the jumps between channels can be anything, they always get the full time
+static uint16_t GetSettleTime() {
+#ifdef SPECTRUM_ADAPTIVE_DWELL
+  if (!channelMode && settleUs[settings.scanStepIndex]) {
+    return settleUs[settings.scanStepIndex];
   }
+#endif
+  return SETTLE_MAX_US;
+}
+
+// waits out what's left of the dwell on the point TunePoint() set up
+static uint16_t GetSweepRssi() {
+  uint16_t settle = GetSettleTime();
+
+  tunePending = false;
+
+#ifdef SPECTRUM_ADAPTIVE_DWELL
+  if (settle < SETTLE_MAX_US && settings.rssiTriggerLevel != RSSI_MAX_VALUE) {
+    // a point still well under the trigger once a carrier would have settled
+    // isn't going to reach it, only the near ones wait out the fixed delay
+    WaitSinceTuned(settle);
+    const uint16_t rssi = BK4819_GetRSSI();
+    if (rssi + DWELL_MARGIN < settings.rssiTriggerLevel) {
+      return rssi;
+    }
+    settle = SETTLE_MAX_US;
+  }
+#endif
+
+  WaitSinceTuned(settle);
   return BK4819_GetRSSI();
 }
 
 uint32_t GetOffsetedF(uint32_t f) {
-  switch (gCurrentVfo->FREQUENCY_DEVIATION_SETTING) {
-  case FREQUENCY_DEVIATION_OFF:
+  switch (g_current_vfo->tx_offset_freq_dir) {
+  case TX_OFFSET_FREQ_DIR_OFF:
     break;
-  case FREQUENCY_DEVIATION_ADD:
-    f += gCurrentVfo->FREQUENCY_OF_DEVIATION;
+  case TX_OFFSET_FREQ_DIR_ADD:
+    f += g_current_vfo->tx_offset_freq;
     break;
-  case FREQUENCY_DEVIATION_SUB:
-    f -= gCurrentVfo->FREQUENCY_OF_DEVIATION;
+  case TX_OFFSET_FREQ_DIR_SUB:
+    f -= g_current_vfo->tx_offset_freq;
     break;
   }
 
-  return Clamp(f, FrequencyBandTable[0].lower,
-               FrequencyBandTable[ARRAY_SIZE(FrequencyBandTable) - 1].upper);
+  return Clamp(f, F_MIN, F_MAX);
 }
 
-bool IsTXAllowed() { return g_setting_ALL_TX != 2; }
+bool IsTXAllowed(uint32_t f) {
+  return g_setting_tx_enable && TX_freq_check(f) == 0;
+}
 
 static void ToggleAudio(bool on) {
   if (on) {
@@ -368,8 +1239,8 @@ static void ToggleRX(bool on) {
   BK4819_RX_TurnOn();
 
   ToggleAudio(on);
-  BK4819_ToggleAFDAC(on);
-  BK4819_ToggleAFBit(on);
+  ToggleAFDAC(on);
+  ToggleAFBit(on);
 
   if (on) {
     listenT = 1000;
@@ -415,8 +1286,8 @@ static void ToggleTX(bool on) {
     BK4819_WriteRegister(BK4819_REG_30, 0xC1FE);
     RegBackupSet(BK4819_REG_51, 0x0000);
 
-    BK4819_SetupPowerAmplifier(gCurrentVfo->TXP_CalculatedSetting,
-                               gCurrentVfo->pTX->Frequency);
+    BK4819_SetupPowerAmplifier(g_current_vfo->txp_calculated_setting,
+                               g_current_vfo->pTX->frequency);
   } else {
     RADIO_SendEndOfTransmission();
     RADIO_EnableCxCSS();
@@ -449,28 +1320,40 @@ static void ResetScanStats() {
 
 static void InitScan() {
   ResetScanStats();
+  tunePending = false;
   scanInfo.i = 0;
-  scanInfo.f = GetFStart();
+  scanInfo.f = GetBinF(0);
 
   scanInfo.scanStep = GetScanStep();
-  scanInfo.measurementsCount = GetStepsCount();
+  scanInfo.measurementsCount = channelMode ? channelCount : GetStepsCount();
+  sweepStart = 0;
+  sweepEnd = scanInfo.measurementsCount;
 }
 
-static void ResetBlacklist() {
-  for (int i = 0; i < 128; ++i) {
-    if (blacklist[i])
-      blacklist[i] = false;
+static void StopCarrierCount() {
+  if (carrierCounting) {
+    BK4819_DisableFrequencyScan();
+    carrierCounting = false;
   }
 }
 
 static void RelaunchScan() {
+  StopCarrierCount();
   InitScan();
   ResetPeak();
-  lastStepsCount = 0;
+  ResetPeaks();
+  ResetStats();
+  if (!channelMode) {
+    ResetWaterfall();
+  }
+  PrefillFromCoarse();
+  MapBlacklist();
   ToggleRX(false);
 #ifdef SPECTRUM_AUTOMATIC_SQUELCH
   settings.rssiTriggerLevel = RSSI_MAX_VALUE;
 #endif
+  // with the cache to show keys can carry on zooming or panning, they're
+  // let through again after the first few bins are refined
   preventKeypress = true;
   scanInfo.rssiMin = RSSI_MAX_VALUE;
 }
@@ -489,7 +1372,11 @@ static void UpdateScanInfo() {
 
 static void AutoTriggerLevel() {
   if (settings.rssiTriggerLevel == RSSI_MAX_VALUE) {
-    settings.rssiTriggerLevel = Clamp(scanInfo.rssiMax + 4, 0, RSSI_MAX_VALUE);
+    autoTrigger = true;
+  }
+  if (autoTrigger && stats.primed) {
+    settings.rssiTriggerLevel =
+        Clamp(stats.noiseFloor + TRIGGER_OVER_NF, 0, RSSI_MAX_VALUE - 1);
   }
 }
 
@@ -511,6 +1398,7 @@ static void Measure() { rssiHistory[scanInfo.i] = scanInfo.rssi = GetRssi(); }
 // Update things by keypress
 
 static void UpdateRssiTriggerLevel(bool inc) {
+  autoTrigger = false;
   if (inc)
     settings.rssiTriggerLevel += 2;
   else
@@ -527,7 +1415,6 @@ static void ApplyPreset(FreqPreset p) {
   settings.stepsCount = p.stepsCountIndex;
   SetModulation(settings.modulationType);
   RelaunchScan();
-  ResetBlacklist();
   redrawScreen = true;
 }
 
@@ -564,7 +1451,6 @@ static void UpdateScanStep(bool inc) {
   }
   settings.frequencyChangeStep = GetBW() >> 1;
   RelaunchScan();
-  ResetBlacklist();
   redrawScreen = true;
 }
 
@@ -577,7 +1463,6 @@ static void UpdateCurrentFreq(bool inc) {
     return;
   }
   RelaunchScan();
-  ResetBlacklist();
   redrawScreen = true;
 }
 
@@ -640,7 +1525,6 @@ static void ToggleStepsCount() {
   }
   settings.frequencyChangeStep = GetBW() >> 1;
   RelaunchScan();
-  ResetBlacklist();
   redrawScreen = true;
 }
 
@@ -705,8 +1589,20 @@ static void UpdateFreqInput(key_code_t key) {
   redrawScreen = true;
 }
 
+// the peak being listened to, otherwise clears the blacklist within the view
 static void Blacklist() {
-  blacklist[peak.i] = true;
+  if (!isListening) {
+    ClearBlacklistInView();
+    MapBlacklist();
+    redrawScreen = true;
+    return;
+  }
+
+  AddToBlacklist(peak.f);
+  MapBlacklist();
+  if (peakCurrent < PEAKS_MAX) {
+    peaks[peakCurrent].f = 0;
+  }
   ResetPeak();
   ToggleRX(false);
   newScanStart = true;
@@ -715,19 +1611,74 @@ static void Blacklist() {
 // Draw things
 
 static uint8_t Rssi2Y(uint16_t rssi) {
-  return DrawingEndY - ConvertDomain(rssi, mov.min - 2,
-                                     mov.max + 30 + (mov.max - mov.min) / 3, 0,
+  return DrawingEndY - ConvertDomain(rssi, stats.min - 2,
+                                     stats.max + 30 + (stats.max - stats.min) / 3, 0,
                                      DrawingEndY);
 }
 
+static uint8_t GetChannelX(uint8_t i) {
+  return channelCount ? ((i * 128) + 64) / channelCount : 0;
+}
+
+// a bar a channel, with a gap between them once they're wide enough for one
+static void DrawChannels() {
+  for (uint16_t x = 0; x < 128; ++x) {
+    const uint8_t i = (x * channelCount) / 128;
+    if (i >= channelCount || IsBlacklisted(i)) {
+      continue;
+    }
+    if (channelCount <= 128 / 3 && ((x + 1) * channelCount) / 128 != i) {
+      continue;
+    }
+    DrawVLine(Rssi2Y(rssiHistory[i]), DrawingEndY, x, true);
+    PutPixel(x, Rssi2Y(stats.hold[i]), true);
+  }
+}
+
+// the first and last channel numbers either end, the peak's number and name
+// between them
+static void DrawChannelNums() {
+  sprintf(String, "%u%s ch", channelCount, channelsTruncated ? "+" : "");
+  UI_PrintStringSmallest(String, 0, 1, false, true);
+  sprintf(String, "%s", channelListOptions[channelList]);
+  UI_PrintStringSmallest(String, 0, 7, false, true);
+
+  if (channelCount == 0) {
+    return;
+  }
+
+  sprintf(String, "%u", channelNum[0] + 1);
+  UI_PrintStringSmallest(String, 0, 49, false, true);
+  sprintf(String, "%3u", channelNum[channelCount - 1] + 1);
+  UI_PrintStringSmallest(String, 116, 49, false, true);
+
+  if (peak.f == 0 || peak.i >= channelCount) {
+    return;
+  }
+  if (channelNameNum != channelNum[peak.i]) {
+    channelNameNum = channelNum[peak.i];
+    BOARD_fetchChannelName(channelName, channelNameNum);
+  }
+  sprintf(String, "CH-%03u %s", channelNameNum + 1, channelName);
+  UI_PrintStringSmallest(String, 28, 49, false, true);
+}
+
 static void DrawSpectrum() {
   for (uint8_t x = 0; x < 128; ++x) {
     uint8_t i = x >> settings.stepsCount;
-    if (blacklist[i]) {
+    if (IsBlacklisted(i)) {
       continue;
     }
     uint16_t rssi = rssiHistory[i];
-    DrawHLine(Rssi2Y(rssi), DrawingEndY, x, true);
+    if (!IsRefined(i)) {
+      // from the cache, just the outline till it's measured
+      if (rssi != 0) {
+        PutPixel(x, Rssi2Y(rssi), true);
+      }
+      continue;
+    }
+    DrawVLine(Rssi2Y(rssi), DrawingEndY, x, true);
+    PutPixel(x, Rssi2Y(stats.hold[i]), true);
   }
 }
 
@@ -749,19 +1700,19 @@ static void UpdateBatteryInfo() {
 
 static void DrawStatus() {
 
-  g_status_line[127] = 0b01111110;
+  g_status_line[127] = __extension__ 0b01111110;
   for (int i = 126; i >= 116; i--) {
-    g_status_line[i] = 0b01000010;
+    g_status_line[i] = __extension__ 0b01000010;
   }
   uint8_t v = g_battery_display_level;
   v <<= 1;
   for (int i = 125; i >= 116; i--) {
     if (126 - i <= v) {
-      g_status_line[i + 2] = 0b01111110;
+      g_status_line[i + 2] = __extension__ 0b01111110;
     }
   }
-  g_status_line[117] = 0b01111110;
-  g_status_line[116] = 0b00011000;
+  g_status_line[117] = __extension__ 0b01111110;
+  g_status_line[116] = __extension__ 0b00011000;
 }
 
 static void DrawF(uint32_t f) {
@@ -770,7 +1721,7 @@ static void DrawF(uint32_t f) {
   if (currentState == STILL && kbd.current == KEY_PTT) {
     if (g_battery_display_level == 6) {
       sprintf(String, "VOLTAGE HIGH");
-    } else if (!IsTXAllowed()) {
+    } else if (!IsTXAllowed(GetOffsetedF(f))) {
       sprintf(String, "DISABLED");
     } else {
       f = GetOffsetedF(f);
@@ -786,11 +1737,21 @@ static void DrawF(uint32_t f) {
 }
 
 static void DrawNums() {
+  if (currentState == SPECTRUM && channelMode) {
+    DrawChannelNums();
+    return;
+  }
+
   if (currentState == SPECTRUM) {
     sprintf(String, "%ux", GetStepsCount());
     UI_PrintStringSmallest(String, 0, 1, false, true);
     sprintf(String, "%u.%02uk", GetScanStep() / 100, GetScanStep() % 100);
     UI_PrintStringSmallest(String, 0, 7, false, true);
+    // beside the step, clear of the waterfall lines, which scroll whatever's
+    // drawn over them .. and left out of the waterfall view anyway
+    if (fastFind && !waterfallMode) {
+      UI_PrintStringSmallest("FAST", 32, 7, false, true);
+    }
   }
 
   if (IsCenterMode()) {
@@ -824,10 +1785,10 @@ static void DrawTicks() {
   uint32_t f = GetFStart() % 100000;
   uint32_t step = GetScanStep();
   for (uint8_t i = 0; i < 128; i += (1 << settings.stepsCount), f += step) {
-    uint8_t barValue = 0b00000001;
-    (f % 10000) < step && (barValue |= 0b00000010);
-    (f % 50000) < step && (barValue |= 0b00000100);
-    (f % 100000) < step && (barValue |= 0b00011000);
+    uint8_t barValue = __extension__ 0b00000001;
+    (f % 10000) < step && (barValue |= __extension__ 0b00000010);
+    (f % 50000) < step && (barValue |= __extension__ 0b00000100);
+    (f % 100000) < step && (barValue |= __extension__ 0b00011000);
 
     g_frame_buffer[5][i] |= barValue;
   }
@@ -856,12 +1817,206 @@ static void DrawArrow(uint8_t x) {
     signed v = x + i;
     uint8_t a = i > 0 ? i : -i;
     if (!(v & 128)) {
-      g_frame_buffer[5][v] |= (0b01111000 << a) & 0b01111000;
+      g_frame_buffer[5][v] |= (__extension__ 0b01111000 << a) & __extension__ 0b01111000;
+    }
+  }
+}
+
+// Waterfall
+
+static void ResetWaterfall() {
+  memset(shared.waterfall, 0, sizeof(shared.waterfall));
+  waterfallRedraw = true;
+}
+
+static uint8_t GetWaterfallLevel(const uint8_t *row, uint8_t x) {
+  return (row[x >> 2] >> ((x & 3) << 1)) & 3;
+}
+
+// quantise the sweep just finished into a new row
+static void AddWaterfallRow() {
+  waterfallHead = (waterfallHead + 1) % WATERFALL_ROWS;
+  waterfallCount++;
+
+  uint8_t *row = shared.waterfall[waterfallHead];
+  memset(row, 0, sizeof(shared.waterfall[0]));
+
+  for (uint8_t x = 0; x < 128; ++x) {
+    uint8_t i = x >> settings.stepsCount;
+    // a fast find window only has its own bins measured this time round
+    if (i < sweepStart || i >= sweepEnd || IsBlacklisted(i) ||
+        rssiHistory[i] <= stats.noiseFloor) {
+      continue;
+    }
+    uint8_t level = Clamp((rssiHistory[i] - stats.noiseFloor) / WATERFALL_STEP, 0, 3);
+    row[x >> 2] |= level << ((x & 3) << 1);
+  }
+
+  waterfallScroll = true;
+}
+
+// 2x2 ordered dither, the phase goes with the row rather than the screen
+// line so a row looks the same once it's been scrolled
+static bool IsWaterfallPixel(const uint8_t *row, uint8_t x, uint8_t phase) {
+  static const uint8_t bayer[2][2] = {{0, 2}, {3, 1}};
+  return GetWaterfallLevel(row, x) > bayer[phase & 1][x & 1];
+}
+
+static void DrawWaterfallRow(uint8_t age) {
+  const uint8_t *row = shared.waterfall[(waterfallHead + WATERFALL_ROWS - age) % WATERFALL_ROWS];
+  const uint8_t phase = waterfallCount - age;
+  uint8_t *line = g_frame_buffer[WATERFALL_LINE + (age >> 3)];
+
+  for (uint8_t x = 0; x < 128; ++x) {
+    if (IsWaterfallPixel(row, x, phase)) {
+      line[x] |= 1u << (age & 7);
+    }
+  }
+}
+
+// move everything down a row (a bit, in the display's column bytes) and
+// draw the newest row in at the top
+static void ScrollWaterfall() {
+  for (uint8_t x = 0; x < 128; ++x) {
+    uint8_t carry = 0;
+    for (uint8_t l = WATERFALL_LINE; l < WATERFALL_LINE + WATERFALL_ROWS / 8; ++l) {
+      uint8_t next = g_frame_buffer[l][x] >> 7;
+      g_frame_buffer[l][x] = (g_frame_buffer[l][x] << 1) | carry;
+      carry = next;
+    }
+  }
+  DrawWaterfallRow(0);
+}
+
+static void RenderWaterfall() {
+  if (waterfallRedraw) {
+    for (uint8_t age = 0; age < WATERFALL_ROWS; ++age) {
+      DrawWaterfallRow(age);
+    }
+  } else if (waterfallScroll) {
+    ScrollWaterfall();
+  }
+  waterfallRedraw = false;
+  waterfallScroll = false;
+}
+
+static void ToggleWaterfall() {
+  waterfallMode = !waterfallMode;
+  waterfallRedraw = true;
+  redrawScreen = true;
+}
+
+static void ToggleFastFind() {
+  fastFind = !fastFind;
+  StopCarrierCount();
+  newScanStart = true;
+  redrawScreen = true;
+}
+
+static void LoadChannels() {
+  static const uint8_t listAttributes[] = {
+      [CHANNELS_ALL] = 0,
+      [CHANNELS_SCANLISTS] = USER_CH_SCANLIST1 | USER_CH_SCANLIST2,
+      [CHANNELS_SCANLIST1] = USER_CH_SCANLIST1,
+      [CHANNELS_SCANLIST2] = USER_CH_SCANLIST2,
+  };
+  const uint8_t wanted = listAttributes[channelList];
+
+  channelCount = 0;
+  channelsTruncated = false;
+  channelNameNum = 0xFF;
+
+  for (uint8_t ch = USER_CHANNEL_FIRST; ch <= USER_CHANNEL_LAST; ++ch) {
+    const uint8_t attributes = g_user_channel_attributes[ch];
+    if ((attributes & USER_CH_BAND_MASK) > BAND7_470MHz) {
+      continue;   // empty
+    }
+    if (wanted && !(attributes & wanted)) {
+      continue;
     }
+
+    // the scan lists' from the index, anything it doesn't have yet is read
+    // in here .. the members that didn't fit in it aren't there at all
+    uint32_t f;
+    if (channelList == CHANNELS_ALL) {
+      f = BOARD_fetchChannelFrequency(ch);
+    } else if (!RADIO_GetIndexedFrequency(ch, &f)) {
+      channelsTruncated = true;
+      continue;
+    }
+    if (f < F_MIN || f > F_MAX) {
+      continue;
+    }
+
+    if (channelCount == CHANNELS_MAX) {
+      channelsTruncated = true;
+      break;
+    }
+    if (channelList == CHANNELS_ALL) {
+      shared.channelF[channelCount] = f;
+    }
+    channelNum[channelCount] = ch;
+    channelCount++;
+  }
+}
+
+static void ToggleChannels() {
+  channelMode = !channelMode;
+  if (channelMode) {
+    LoadChannels();
+  }
+  RelaunchScan();
+  redrawScreen = true;
+}
+
+static void NextChannelList(bool inc) {
+  channelList = (channelList + (inc ? 1 : CHANNELS_LIST_COUNT - 1)) %
+                CHANNELS_LIST_COUNT;
+  LoadChannels();
+  RelaunchScan();
+  redrawScreen = true;
+}
+
+// MENU steps through the spectrum and the waterfall, both again in fast find,
+// then the memory channels
+static void NextView() {
+  if (channelMode) {
+    ToggleChannels();
+    return;
+  }
+  ToggleWaterfall();
+  if (!waterfallMode) {
+    if (fastFind) {
+      ToggleChannels();
+    }
+    ToggleFastFind();
+  }
+}
+
+// the span keys mean nothing across the channels, up and down pick the list
+static bool OnKeyDownChannels(uint8_t key) {
+  switch (key) {
+  case KEY_UP:
+    NextChannelList(true);
+    return true;
+  case KEY_DOWN:
+    NextChannelList(false);
+    return true;
+  case KEY_1:
+  case KEY_2:
+  case KEY_3:
+  case KEY_4:
+  case KEY_7:
+  case KEY_8:
+  case KEY_9:
+    return true;
+  default:
+    return false;
   }
 }
 
 static void DeInitSpectrum() {
+  StopCarrierCount();
   SetF(initialFreq);
   ToggleRX(false);
   RestoreRegisters();
@@ -869,6 +2024,10 @@ static void DeInitSpectrum() {
 }
 
 static void OnKeyDown(uint8_t key) {
+  if (channelMode && OnKeyDownChannels(key)) {
+    return;
+  }
+
   switch (key) {
   case KEY_3:
     SelectNearestPreset(true);
@@ -919,11 +2078,14 @@ static void OnKeyDown(uint8_t key) {
     ToggleBacklight();
     break;
   case KEY_PTT:
+    StopCarrierCount();
     SetState(STILL);
     TuneToPeak();
+    autoTrigger = false;
     settings.rssiTriggerLevel = 120;
     break;
   case KEY_MENU:
+    NextView();
     break;
   case KEY_EXIT:
     if (menuState) {
@@ -966,7 +2128,6 @@ static void OnKeyDownFreqInput(uint8_t key) {
     SetState(previousState);
     currentFreq = tempFreq;
     if (currentState == SPECTRUM) {
-      ResetBlacklist();
       RelaunchScan();
     } else {
       SetF(currentFreq);
@@ -1021,7 +2182,7 @@ void OnKeyDownStill(key_code_t key) {
   case KEY_PTT:
     // start transmit
     UpdateBatteryInfo();
-    if (g_battery_display_level != 6 && IsTXAllowed()) {
+    if (g_battery_display_level != 6 && IsTXAllowed(GetOffsetedF(fMeasure))) {
       ToggleTX(true);
     }
     redrawScreen = true;
@@ -1055,7 +2216,7 @@ static void OnKeysReleased() {
 }
 
 static void RenderFreqInput() {
-  UI_PrintString(freqInputString, 2, 127, 0, 8, true);
+  UI_PrintString(freqInputString, 2, 127, 0, 8);
 }
 
 static void RenderStatus() {
@@ -1065,10 +2226,18 @@ static void RenderStatus() {
 }
 
 static void RenderSpectrum() {
-  DrawTicks();
-  DrawArrow(peak.i << settings.stepsCount);
-  DrawSpectrum();
-  DrawRssiTriggerLevel();
+  if (channelMode) {
+    DrawArrow(GetChannelX(peak.i));
+    DrawChannels();
+    DrawRssiTriggerLevel();
+  } else if (waterfallMode) {
+    RenderWaterfall();
+  } else {
+    DrawTicks();
+    DrawArrow(peak.i << settings.stepsCount);
+    DrawSpectrum();
+    DrawRssiTriggerLevel();
+  }
   DrawF(peak.f);
   DrawNums();
 }
@@ -1080,16 +2249,16 @@ static void RenderStill() {
 
   for (int i = 0; i < 121; i++) {
     if (i % 10 == 0) {
-      g_frame_buffer[2][i + METER_PAD_LEFT] = 0b11000000;
+      g_frame_buffer[2][i + METER_PAD_LEFT] = __extension__ 0b11000000;
     } else {
-      g_frame_buffer[2][i + METER_PAD_LEFT] = 0b01000000;
+      g_frame_buffer[2][i + METER_PAD_LEFT] = __extension__ 0b01000000;
     }
   }
 
   uint8_t x = Rssi2PX(scanInfo.rssi, 0, 121);
   for (int i = 0; i < x; ++i) {
     if (i % 5 && i / 5 < x / 5) {
-      g_frame_buffer[2][i + METER_PAD_LEFT] |= 0b00011100;
+      g_frame_buffer[2][i + METER_PAD_LEFT] |= __extension__ 0b00011100;
     }
   }
 
@@ -1105,18 +2274,18 @@ static void RenderStill() {
   UI_PrintStringSmallest(String, 32, 10, false, true);
 
   if (isTransmitting) {
-    uint8_t afDB = BK4819_ReadRegister(0x6F) & 0b1111111;
+    uint8_t afDB = BK4819_ReadRegister(0x6F) & __extension__ 0b1111111;
     uint8_t afPX = ConvertDomain(afDB, 26, 194, 0, 121);
     for (int i = 0; i < afPX; ++i) {
-      g_frame_buffer[3][i + METER_PAD_LEFT] |= 0b00000011;
+      g_frame_buffer[3][i + METER_PAD_LEFT] |= __extension__ 0b00000011;
     }
   }
 
   if (!monitorMode) {
     uint8_t x = Rssi2PX(settings.rssiTriggerLevel, 0, 121);
-    g_frame_buffer[2][METER_PAD_LEFT + x - 1] |= 0b01000001;
-    g_frame_buffer[2][METER_PAD_LEFT + x] = 0b01111111;
-    g_frame_buffer[2][METER_PAD_LEFT + x + 1] |= 0b01000001;
+    g_frame_buffer[2][METER_PAD_LEFT + x - 1] |= __extension__ 0b01000001;
+    g_frame_buffer[2][METER_PAD_LEFT + x] = __extension__ 0b01111111;
+    g_frame_buffer[2][METER_PAD_LEFT + x + 1] |= __extension__ 0b01000001;
   }
 
   const uint8_t PAD_LEFT = 4;
@@ -1147,7 +2316,16 @@ static void RenderStill() {
 }
 
 static void Render() {
-  memset(g_frame_buffer, 0, sizeof(g_frame_buffer));
+  if (currentState == SPECTRUM && waterfallMode && !waterfallRedraw) {
+    // the waterfall lines are kept from frame to frame
+    memset(g_frame_buffer, 0, sizeof(g_frame_buffer[0]) * WATERFALL_LINE);
+    memset(g_frame_buffer[WATERFALL_LINE + WATERFALL_ROWS / 8], 0,
+           sizeof(g_frame_buffer[0]) *
+               (ARRAY_SIZE(g_frame_buffer) - WATERFALL_LINE - WATERFALL_ROWS / 8));
+  } else {
+    memset(g_frame_buffer, 0, sizeof(g_frame_buffer));
+    waterfallRedraw = true;
+  }
 
   switch (currentState) {
   case SPECTRUM:
@@ -1196,42 +2374,172 @@ bool HandleUserInput() {
   return true;
 }
 
-static void Scan() {
-  if (blacklist[scanInfo.i]) {
-    return;
-  }
-  SetF(scanInfo.f);
-  Measure();
-  UpdateScanInfo();
-}
-
 static void NextScanStep() {
   ++peak.t;
   ++scanInfo.i;
-  scanInfo.f += scanInfo.scanStep;
+  if (!channelMode) {
+    scanInfo.f += scanInfo.scanStep;
+  } else if (scanInfo.i < channelCount) {
+    scanInfo.f = GetChannelF(scanInfo.i);
+  }
+}
+
+static void SkipBlacklisted() {
+  while (scanInfo.i < sweepEnd && IsBlacklisted(scanInfo.i)) {
+    NextScanStep();
+  }
+}
+
+// tunes to the next peak in the table that was over the trigger level, false
+// once the round's reached the end of the table .. a round starts after each
+// sweep, so the table's refreshed however long something stays on the air
+static bool ListenNextPeak() {
+  const uint8_t start = peakCurrent < PEAKS_MAX ? peakCurrent + 1 : 0;
+
+  for (uint8_t k = start; k < PEAKS_MAX; ++k) {
+    const ActivePeak *p = &peaks[k];
+    if (p->f == 0 || p->rssi < settings.rssiTriggerLevel) {
+      continue;
+    }
+
+    peakCurrent = k;
+    peak.t = 0;
+    peak.f = p->f;
+    peak.rssi = p->rssi;
+    peak.i = p->i;
+
+    if (!isListening) {
+      ToggleRX(true);
+    }
+    TuneToPeak();
+
+    // it might be a while since it was heard, so have a quick listen first
+    peakChecking = true;
+    listenT = PEAK_CHECK;
+    return true;
+  }
+
+  peakCurrent = PEAKS_MAX;
+  return false;
+}
+
+// tunes the first point of a sweep, the caller carries on while it settles
+static void StartSweep() {
+  SkipBlacklisted();
+  if (scanInfo.i < sweepEnd) {
+    TunePoint(scanInfo.f);
+  }
+}
+
+// counts carriers till one's found in the span, then narrows the sweep to
+// the bins either side of it .. false while it's still counting
+static bool FindCarrier() {
+  if (!carrierCounting) {
+    BK4819_PickRXFilterPathBasedOnFrequency(0xFFFFFFFF);
+    BK4819_EnableFrequencyScan();
+    carrierCounting = true;
+    carrierHits = 0;
+    return false;
+  }
+
+  uint32_t f;
+  if (!BK4819_GetFrequencyScanResult(&f)) {
+    SYSTEM_DelayMs(FAST_FIND_POLL_MS);
+    return false;   // still counting
+  }
+
+  BK4819_DisableFrequencyScan();
+
+  // the same within 1kHz a couple of times running, as the scanner does
+  carrierHits = ((f > carrierF ? f - carrierF : carrierF - f) < 100)
+                    ? carrierHits + 1
+                    : 0;
+  carrierF = f;
+
+  const uint32_t fStart = GetFStart();
+  if (carrierHits < FAST_FIND_HITS || f < fStart ||
+      f >= fStart + scanInfo.measurementsCount * scanInfo.scanStep) {
+    BK4819_EnableFrequencyScan();
+    return false;
+  }
+
+  carrierCounting = false;
+
+  uint8_t bin = (f - fStart + (scanInfo.scanStep >> 1)) / scanInfo.scanStep;
+  if (bin >= scanInfo.measurementsCount) {
+    bin = scanInfo.measurementsCount - 1;
+  }
+  scanInfo.i = bin > FAST_FIND_BINS ? bin - FAST_FIND_BINS : 0;
+  sweepStart = scanInfo.i;
+  scanInfo.f = fStart + scanInfo.i * scanInfo.scanStep;
+  sweepEnd = bin + FAST_FIND_BINS + 1;
+  if (sweepEnd > scanInfo.measurementsCount) {
+    sweepEnd = scanInfo.measurementsCount;
+  }
+  return true;
 }
 
 static void UpdateScan() {
-  Scan();
+  if (!tunePending) {
+    // a whole sweep first after each relaunch, the windows round a carrier
+    // would leave the noise floor and the levels with nothing to go on
+    if (fastFind && stats.primed && !FindCarrier()) {
+      preventKeypress = false;   // no sweep to wait for till there's a carrier
+      return;
+    }
+    StartSweep();
+  }
+
+  if (scanInfo.i < sweepEnd) {
+    rssiHistory[scanInfo.i] = scanInfo.rssi = GetSweepRssi();
+    UpdateScanInfo();
+    UpdateStats(scanInfo.i, scanInfo.rssi);
+    MarkRefined(scanInfo.i);
+
+    // a view drawn from the cache is redrawn as it's refined
+    if (refining && (scanInfo.i % REFINE_REDRAW_BINS) == REFINE_REDRAW_BINS - 1) {
+      redrawScreen = true;
+      preventKeypress = false;
+    }
 
-  if (scanInfo.i < scanInfo.measurementsCount) {
     NextScanStep();
-    return;
+    SkipBlacklisted();
+    if (scanInfo.i < sweepEnd) {
+      TunePoint(scanInfo.f);
+      return;
+    }
   }
 
-  MoveHistory();
+  // a fast find window isn't the whole view, its bins would skew the floor
+  if (sweepStart == 0 && sweepEnd == scanInfo.measurementsCount) {
+    FinishStats();
+#ifdef SPECTRUM_ADAPTIVE_DWELL
+    MeasureSettleTime();
+#endif
+  } else {
+    ResetSweepStats();
+  }
+  UpdateCoarse();
+  if (!channelMode) {
+    AddWaterfallRow();
+  }
 
   redrawScreen = true;
   preventKeypress = false;
 
   UpdatePeakInfo();
-  if (IsPeakOverLevel()) {
-    ToggleRX(true);
-    TuneToPeak();
+  UpdatePeakTable();
+  peakCurrent = PEAKS_MAX;   // a new round of the table
+  if (ListenNextPeak()) {
     return;
   }
 
-  newScanStart = true;
+  // the next sweep's first point settles while this one's drawn, unless
+  // there's a carrier to find first
+  InitScan();
+  if (!fastFind) {
+    StartSweep();
+  }
 }
 
 static void UpdateStill() {
@@ -1270,8 +2578,20 @@ static void UpdateListening() {
   peak.rssi = scanInfo.rssi;
   redrawScreen = true;
 
-  if (IsPeakOverLevel() || monitorMode) {
-    listenT = 1000;
+  if (peakCurrent < PEAKS_MAX) {
+    peaks[peakCurrent].rssi = peak.rssi;
+  }
+
+  if (monitorMode ||
+      (IsPeakOverLevel() && (peakChecking || currentState == STILL))) {
+    peakChecking = false;
+    listenT = PEAK_DWELL;
+    return;
+  }
+
+  // its dwell's up, or it's gone .. on to the next in the table, and back to
+  // sweeping once the round's done
+  if (currentState == SPECTRUM && ListenNextPeak()) {
     return;
   }
 
@@ -1316,7 +2636,7 @@ static void Tick() {
 }
 
 static void AutomaticPresetChoose(uint32_t f) {
-  for (int i = 0; i < ARRAY_SIZE(freqPresets); ++i) {
+  for (unsigned int i = 0; i < ARRAY_SIZE(freqPresets); ++i) {
     FreqPreset p = freqPresets[i];
     if (f >= p.fStart && f <= freqPresets[i].fEnd) {
       ApplyPreset(p);
@@ -1327,14 +2647,14 @@ static void AutomaticPresetChoose(uint32_t f) {
 void APP_RunSpectrum() {
   BackupRegisters();
   // TX here coz it always? set to active VFO
-  VFO_Info_t vfo = g_eeprom.vfo_info[g_eeprom.TX_CHANNEL];
-  initialFreq = vfo.pRX->Frequency;
+  const vfo_info_t *vfo = &g_eeprom.vfo_info[g_eeprom.tx_vfo];
+  initialFreq = vfo->pRX->frequency;
   currentFreq = initialFreq;
-  settings.scanStepIndex = gStepSettingToIndex[vfo.STEP_SETTING];
-  settings.listenBw = vfo.CHANNEL_BANDWIDTH == BANDWIDTH_WIDE
-                          ? BANDWIDTH_WIDE
-                          : BANDWIDTH_NARROW;
-  settings.modulationType = vfo.IsAM ? MOD_AM : MOD_FM;
+  settings.scanStepIndex = gStepSettingToIndex[vfo->step_setting];
+  settings.listenBw = vfo->channel_bandwidth == BANDWIDTH_WIDE
+                          ? BK4819_FILTER_BW_WIDE
+                          : BK4819_FILTER_BW_NARROW;
+  settings.modulationType = vfo->am_mode ? MOD_AM : MOD_FM;
 
   AutomaticPresetChoose(currentFreq);
 
@@ -1345,6 +2665,7 @@ void APP_RunSpectrum() {
   ToggleRX(true), ToggleRX(false); // hack to prevent noise when squelch off
   SetModulation(settings.modulationType);
 
+  FormatBlacklist();
   RelaunchScan();
 
   for (int i = 0; i < 128; ++i) {
@@ -35,7 +35,15 @@
 #include "driver/gpio.h"
 #include "driver/uart.h"
 #include "functions.h"
+#include "init.h"
+#ifdef ENABLE_PROFILER
+	#include "helper/profiler.h"
+#endif
+#ifdef ENABLE_BUS_TRACE
+	#include "helper/trace.h"
+#endif
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 #if defined(ENABLE_OVERLAY)
 	#include "sram-overlay.h"
@@ -127,6 +135,66 @@ typedef struct {
 	} __attribute__((packed)) Data;
 } __attribute__((packed)) reply_0529_t;
 
+typedef struct {
+	Header_t Header;
+	struct {
+		uint8_t IdlePercent;     // CPU time spent in WFI over the last 500ms
+		uint8_t KeyLatency;      // 10ms ticks from the last key press to it being handled
+		uint8_t pad[2];
+	} __attribute__((packed)) Data;
+} __attribute__((packed)) reply_0531_t;
+
+typedef struct {
+	Header_t Header;
+	struct {
+		uint16_t StackUsed;      // bytes, deepest since reset
+		uint16_t StackSize;      // bytes between the end of .bss and the top of the stack
+	} __attribute__((packed)) Data;
+} __attribute__((packed)) reply_0535_t;
+
+#ifdef ENABLE_PROFILER
+	typedef struct {
+		Header_t Header;
+		uint8_t  Reset;          // non-zero to clear the table once it's been read
+		uint8_t  pad[3];
+	} __attribute__((packed)) cmd_052B_t;
+
+	typedef struct {
+		Header_t Header;
+		struct {
+			struct {
+				uint32_t Min;    // CPU clocks, 48 per us
+				uint32_t Avg;
+				uint32_t Max;
+				uint32_t Count;
+			} __attribute__((packed)) Entry[PROFILE_COUNT];
+		} __attribute__((packed)) Data;
+	} __attribute__((packed)) reply_052B_t;
+#endif
+
+#ifdef ENABLE_BUS_TRACE
+	#define TRACE_PAUSE  (1u << 0)   // stop logging (so the ring can be read back in one piece)
+	#define TRACE_CLEAR  (1u << 1)   // empty the ring once it's been read
+
+	typedef struct {
+		Header_t Header;
+		uint16_t Index;          // first entry wanted, 0 = the oldest still in the ring
+		uint8_t  Flags;          // TRACE_xxx
+		uint8_t  pad;
+	} __attribute__((packed)) cmd_0533_t;
+
+	typedef struct {
+		Header_t Header;
+		struct {
+			uint32_t      Total;     // entries logged since the last clear
+			uint16_t      Index;
+			uint8_t       Count;     // entries that follow
+			uint8_t       Size;      // TRACE_SIZE
+			trace_entry_t Entry[16];
+		} __attribute__((packed)) Data;
+	} __attribute__((packed)) reply_0533_t;
+#endif
+
 typedef struct {
 	Header_t Header;
 	uint32_t Response[4];
@@ -249,7 +317,7 @@ static void cmd_0514(const uint8_t *pBuffer)
 
 	time_stamp = pCmd->time_stamp;
 
-	g_serial_config_count_down_500ms = serial_config_count_down_500ms;
+	SCHEDULER_StartTimer(TIMER_SERIAL_CONFIG, serial_config_count_down_500ms);
 
 	// show message
 	g_request_display_screen = DISPLAY_MAIN;
@@ -270,7 +338,7 @@ static void cmd_051B(const uint8_t *pBuffer)
 //	if (pCmd->time_stamp != time_stamp)
 //		return;
 
-	g_serial_config_count_down_500ms = serial_config_count_down_500ms;
+	SCHEDULER_StartTimer(TIMER_SERIAL_CONFIG, serial_config_count_down_500ms);
 
 	if (addr >= EEPROM_SIZE)
 		return;
@@ -314,7 +382,7 @@ static void cmd_051D(const uint8_t *pBuffer)
 //	if (pCmd->time_stamp != time_stamp)
 //		return;
 
-	g_serial_config_count_down_500ms = serial_config_count_down_500ms;
+	SCHEDULER_StartTimer(TIMER_SERIAL_CONFIG, serial_config_count_down_500ms);
 
 	if (addr >= EEPROM_SIZE)
 		return;
@@ -336,28 +404,27 @@ static void cmd_051D(const uint8_t *pBuffer)
 	if (!locked)
 #endif
 	{
-		const uint8_t *data = (uint8_t *)&pCmd + sizeof(cmd_051D_t); // point to the RX'ed data to write to eeprom
-		unsigned int i;
-		for (i = 0; i < (size / write_size); i++)
-		{
-			const uint16_t Offset = addr + (i * write_size);
+		const uint8_t *data = pBuffer + sizeof(cmd_051D_t); // point to the RX'ed data to write to eeprom
 
-			if ((Offset + write_size) > EEPROM_SIZE)
-				break;
+		size -= size % write_size;   // whole blocks only, as always
 
-			#ifdef INCLUDE_AES
-				if (Offset >= 0x0F30 && Offset < 0x0F40)     // AES key
-					if (!is_locked)
-						reload_eeprom = true;
-			#endif
+		#ifdef INCLUDE_AES
+			if (addr < 0x0F40 && (addr + size) > 0x0F30)     // AES key
+				if (!is_locked)
+					reload_eeprom = true;
+		#endif
 
-			#ifdef ENABLE_PWRON_PASSWORD
-				if ((Offset < 0x0E98 || Offset >= 0x0EA0) || !g_password_locked || pCmd->bAllowPassword)
-					EEPROM_WriteBuffer(Offset, &pCmd->Data[i * write_size]);
-			#else
-				EEPROM_WriteBuffer(Offset, &data[i * write_size]);
-			#endif
-		}
+		#ifdef ENABLE_PWRON_PASSWORD
+			if (g_password_locked && !pCmd->allow_password && addr < 0x0EA0 && (addr + size) > 0x0E98)
+			{	// leave the password alone
+				if (addr < 0x0E98)
+					EEPROM_Write(addr, data, 0x0E98 - addr);
+				if ((addr + size) > 0x0EA0)
+					EEPROM_Write(0x0EA0, &data[0x0EA0 - addr], (addr + size) - 0x0EA0);
+			}
+			else
+		#endif
+			EEPROM_Write(addr, data, size);
 
 		#ifdef INCLUDE_AES
 			if (reload_eeprom)
@@ -399,6 +466,65 @@ static void cmd_0529(void)
 	SendReply(&reply, sizeof(reply));
 }
 
+#ifdef ENABLE_PROFILER
+// read the hot path timings
+static void cmd_052B(const uint8_t *pBuffer)
+{
+	const cmd_052B_t *pCmd = (const cmd_052B_t *)pBuffer;
+	reply_052B_t      reply;
+	unsigned int      i;
+
+	memset(&reply, 0, sizeof(reply));
+	reply.Header.ID   = 0x052C;
+	reply.Header.Size = sizeof(reply.Data);
+
+	for (i = 0; i < PROFILE_COUNT; i++)
+	{
+		const profiler_entry_t *pEntry = &g_profiler[i];
+		if (pEntry->count == 0)
+			continue;
+		reply.Data.Entry[i].Min   = pEntry->min;
+		reply.Data.Entry[i].Avg   = (uint32_t)(pEntry->total / pEntry->count);
+		reply.Data.Entry[i].Max   = pEntry->max;
+		reply.Data.Entry[i].Count = pEntry->count;
+	}
+
+	if (pCmd->Reset)
+		PROFILER_Reset();
+
+	SendReply(&reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_BUS_TRACE
+// read the bus trace ring
+static void cmd_0533(const uint8_t *pBuffer)
+{
+	const cmd_0533_t *pCmd   = (const cmd_0533_t *)pBuffer;
+	const uint32_t    oldest = (g_trace_count > TRACE_SIZE) ? g_trace_count - TRACE_SIZE : 0;
+	const uint32_t    held   = g_trace_count - oldest;
+	reply_0533_t      reply;
+	unsigned int      i;
+
+	memset(&reply, 0, sizeof(reply));
+	reply.Header.ID   = 0x0534;
+	reply.Header.Size = sizeof(reply.Data);
+	reply.Data.Total  = g_trace_count;
+	reply.Data.Index  = pCmd->Index;
+	reply.Data.Size   = TRACE_SIZE;
+
+	for (i = 0; i < ARRAY_SIZE(reply.Data.Entry) && (pCmd->Index + i) < held; i++)
+		reply.Data.Entry[i] = g_trace[(oldest + pCmd->Index + i) % TRACE_SIZE];
+	reply.Data.Count = i;
+
+	g_trace_paused = (pCmd->Flags & TRACE_PAUSE) ? true : false;
+	if (pCmd->Flags & TRACE_CLEAR)
+		TRACE_Clear();
+
+	SendReply(&reply, sizeof(reply));
+}
+#endif
+
 #ifdef INCLUDE_AES
 
 static void cmd_052D(const uint8_t *pBuffer)
@@ -408,7 +534,7 @@ static void cmd_052D(const uint8_t *pBuffer)
 	uint32_t     response[4];
 	reply_052D_t reply;
 
-	g_serial_config_count_down_500ms = serial_config_count_down_500ms;
+	SCHEDULER_StartTimer(TIMER_SERIAL_CONFIG, serial_config_count_down_500ms);
 
 	if (!locked)
 	{
@@ -462,7 +588,7 @@ static void cmd_052F(const uint8_t *pBuffer)
 	g_eeprom.vfo_info[0].dtmf_ptt_id_tx_mode  = PTT_ID_OFF;
 	g_eeprom.vfo_info[0].dtmf_decoding_enable = false;
 
-	g_serial_config_count_down_500ms = serial_config_count_down_500ms;
+	SCHEDULER_StartTimer(TIMER_SERIAL_CONFIG, serial_config_count_down_500ms);
 
 	#ifdef ENABLE_NOAA
 		g_is_noaa_mode = false;
@@ -480,6 +606,40 @@ static void cmd_052F(const uint8_t *pBuffer)
 	SendVersion();
 }
 
+// read CPU stats
+static void cmd_0531(void)
+{
+	reply_0531_t reply;
+
+	memset(&reply, 0, sizeof(reply));
+	reply.Header.ID        = 0x0532;
+	reply.Header.Size      = sizeof(reply.Data);
+	reply.Data.IdlePercent = g_cpu_idle_percent;
+	reply.Data.KeyLatency  = g_key_latency_10ms;
+
+	SendReply(&reply, sizeof(reply));
+}
+
+// read the stack high water mark
+static void cmd_0535(void)
+{
+	reply_0535_t reply;
+
+	memset(&reply, 0, sizeof(reply));
+	reply.Header.ID      = 0x0536;
+	reply.Header.Size    = sizeof(reply.Data);
+	reply.Data.StackUsed = STACK_GetHighWater();
+	reply.Data.StackSize = STACK_GetSize();
+
+	SendReply(&reply, sizeof(reply));
+}
+
+// something's arrived that UART_IsCommandAvailable() hasn't looked at yet
+bool UART_IsDataPending(void)
+{
+	return (write_index != (DMA_CH0->ST & 0xFFFU)) ? true : false;
+}
+
 bool UART_IsCommandAvailable(void)
 {
 	uint16_t Index;
@@ -602,6 +762,12 @@ void UART_HandleCommand(void)
 		case 0x0529:    // read ADC
 			cmd_0529();
 			break;
+
+		#ifdef ENABLE_PROFILER
+			case 0x052B:    // read the profiler table
+				cmd_052B(UART_Command.Buffer);
+				break;
+		#endif
 			
 #ifdef INCLUDE_AES
 		case 0x052D:    //
@@ -613,7 +779,23 @@ void UART_HandleCommand(void)
 			cmd_052F(UART_Command.Buffer);
 			break;
 
+		case 0x0531:    // read CPU stats
+			cmd_0531();
+			break;
+
+		#ifdef ENABLE_BUS_TRACE
+			case 0x0533:    // read the bus trace
+				cmd_0533(UART_Command.Buffer);
+				break;
+		#endif
+
+		case 0x0535:    // read the stack high water mark
+			cmd_0535();
+			break;
+
 		case 0x05DD:    // reboot
+			EEPROM_Flush();
+
 			#if defined(ENABLE_OVERLAY)
 				overlay_FLASH_RebootToBootloader();
 			#else
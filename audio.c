@@ -28,6 +28,7 @@
 #include "driver/systick.h"
 #include "functions.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/ui.h"
 
@@ -319,7 +320,7 @@ void AUDIO_PlayBeep(beep_type_t Beep)
 		}
 
 		g_voice_read_index                   = 1;
-		g_count_down_to_play_next_voice_10ms = Delay;
+		SCHEDULER_StartTimer(TIMER_VOICE, Delay);
 		g_flag_play_queued_voice             = false;
 
 		return;
@@ -431,7 +432,7 @@ void AUDIO_PlayBeep(beep_type_t Beep)
 
 				AUDIO_PlayVoice(VoiceID);
 
-				g_count_down_to_play_next_voice_10ms = Delay;
+				SCHEDULER_StartTimer(TIMER_VOICE, Delay);
 				g_flag_play_queued_voice           = false;
 
 				#ifdef ENABLE_VOX
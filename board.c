@@ -40,6 +40,7 @@
 #include "frequencies.h"
 #include "helper/battery.h"
 #include "misc.h"
+#include "radio.h"
 #include "settings.h"
 #if defined(ENABLE_OVERLAY)
 	#include "sram-overlay.h"
@@ -749,6 +750,10 @@ void BOARD_EEPROM_load(void)
 
 	// 0D60..0E27
 	EEPROM_ReadBuffer(0x0D60, g_user_channel_attributes, sizeof(g_user_channel_attributes));
+	RADIO_BuildScanLists();
+
+	// 0000..0C7F .. the memory channels themselves, for the scanner
+	RADIO_BuildChannelIndex();
 
 	// *****************************
 	
@@ -886,7 +891,7 @@ void BOARD_FactoryReset(bool bIsAll)
 		if (
 			!(i >= 0x0EE0 && i < 0x0F18) &&         // ANI ID + DTMF codes
 			!(i >= 0x0F30 && i < 0x0F50) &&         // AES KEY + F LOCK + Scramble Enable
-			!(i >= 0x1C00 && i < 0x1E00) &&         // DTMF contacts
+			!(i >= 0x1C00 && i < 0x1E00) &&         // DTMF contacts + spectrum blacklist
 			!(i >= 0x0EB0 && i < 0x0ED0) &&         // Welcome strings
 			!(i >= 0x0EA0 && i < 0x0EA8) &&         // Voice Prompt
 			(bIsAll ||
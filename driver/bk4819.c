@@ -16,12 +16,16 @@
 
 #include <stdio.h>   // NULL
 
+#include "ARMCM0.h"
 #include "bk4819.h"
 #include "bsp/dp32g030/gpio.h"
 #include "bsp/dp32g030/portcon.h"
 #include "driver/gpio.h"
 #include "driver/system.h"
 #include "driver/systick.h"
+#ifdef ENABLE_BUS_TRACE
+	#include "helper/trace.h"
+#endif
 
 #ifndef ARRAY_SIZE
 	#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
@@ -39,24 +43,20 @@ __inline uint16_t scale_freq(const uint16_t freq)
 	return (((uint32_t)freq * 1353245u) + (1u << 16)) >> 17;   // with rounding
 }
 
-void BK4819_Init(void)
+static const BK4819_reg_val_t init_reset_regs[] =
 {
-	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
-	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
-	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
-
-	BK4819_WriteRegister(BK4819_REG_00, 0x8000);
-	BK4819_WriteRegister(BK4819_REG_00, 0x0000);
-
-	BK4819_WriteRegister(BK4819_REG_37, 0x1D0F);
-	BK4819_WriteRegister(BK4819_REG_36, 0x0022);
+	{BK4819_REG_00, 0x8000},
+	{BK4819_REG_00, 0x0000},
 
-	BK4819_SetAGC(0);
-//	BK4819_SetAGC(1);
+	{BK4819_REG_37, 0x1D0F},
+	{BK4819_REG_36, 0x0022}
+};
 
-	BK4819_WriteRegister(BK4819_REG_19, 0x1041);  // 0001 0000 0100 0001 <15> MIC AGC  1 = disable  0 = enable
+static const BK4819_reg_val_t init_regs[] =
+{
+	{BK4819_REG_19, 0x1041},  // 0001 0000 0100 0001 <15> MIC AGC  1 = disable  0 = enable
 
-	BK4819_WriteRegister(BK4819_REG_7D, 0xE940);
+	{BK4819_REG_7D, 0xE940},
 
 	// REG_48 .. RX AF level
 	//
@@ -76,45 +76,56 @@ void BK4819_Init(void)
 	//         15 = max
 	//          0 = min
 	//
-	BK4819_WriteRegister(BK4819_REG_48,	//  0xB3A8);     // 1011 00 111010 1000
+	{BK4819_REG_48,	//  0xB3A8);     // 1011 00 111010 1000
 		(11u << 12) |     // ??? 0..15
 		( 0u << 10) |     // AF Rx Gain-1
 		(58u <<  4) |     // AF Rx Gain-2
-		( 8u <<  0));     // AF DAC Gain (after Gain-1 and Gain-2)
-
-#if 1
-	const uint8_t dtmf_coeffs[] = {111, 107, 103, 98, 80, 71, 58, 44, 65, 55, 37, 23, 228, 203, 181, 159};
-	for (unsigned int i = 0; i < ARRAY_SIZE(dtmf_coeffs); i++)
-		BK4819_WriteRegister(BK4819_REG_09, (i << 12) | dtmf_coeffs[i]);
-#else
-	// original code
-	BK4819_WriteRegister(BK4819_REG_09, 0x006F);  // 6F
-	BK4819_WriteRegister(BK4819_REG_09, 0x106B);  // 6B
-	BK4819_WriteRegister(BK4819_REG_09, 0x2067);  // 67
-	BK4819_WriteRegister(BK4819_REG_09, 0x3062);  // 62
-	BK4819_WriteRegister(BK4819_REG_09, 0x4050);  // 50
-	BK4819_WriteRegister(BK4819_REG_09, 0x5047);  // 47
-	BK4819_WriteRegister(BK4819_REG_09, 0x603A);  // 3A
-	BK4819_WriteRegister(BK4819_REG_09, 0x702C);  // 2C
-	BK4819_WriteRegister(BK4819_REG_09, 0x8041);  // 41
-	BK4819_WriteRegister(BK4819_REG_09, 0x9037);  // 37
-	BK4819_WriteRegister(BK4819_REG_09, 0xA025);  // 25
-	BK4819_WriteRegister(BK4819_REG_09, 0xB017);  // 17
-	BK4819_WriteRegister(BK4819_REG_09, 0xC0E4);  // E4
-	BK4819_WriteRegister(BK4819_REG_09, 0xD0CB);  // CB
-	BK4819_WriteRegister(BK4819_REG_09, 0xE0B5);  // B5
-	BK4819_WriteRegister(BK4819_REG_09, 0xF09F);  // 9F
-#endif
+		( 8u <<  0)},     // AF DAC Gain (after Gain-1 and Gain-2)
+
+	// DTMF coeffs
+	{BK4819_REG_09, 0x006F},  // 6F
+	{BK4819_REG_09, 0x106B},  // 6B
+	{BK4819_REG_09, 0x2067},  // 67
+	{BK4819_REG_09, 0x3062},  // 62
+	{BK4819_REG_09, 0x4050},  // 50
+	{BK4819_REG_09, 0x5047},  // 47
+	{BK4819_REG_09, 0x603A},  // 3A
+	{BK4819_REG_09, 0x702C},  // 2C
+	{BK4819_REG_09, 0x8041},  // 41
+	{BK4819_REG_09, 0x9037},  // 37
+	{BK4819_REG_09, 0xA025},  // 25
+	{BK4819_REG_09, 0xB017},  // 17
+	{BK4819_REG_09, 0xC0E4},  // E4
+	{BK4819_REG_09, 0xD0CB},  // CB
+	{BK4819_REG_09, 0xE0B5},  // B5
+	{BK4819_REG_09, 0xF09F},  // 9F
+
+	{BK4819_REG_1F, 0x5454},
+	{BK4819_REG_3E, 0xA037},
+
+	{BK4819_REG_33, 0x9000},  // gBK4819_GpioOutState
+	{BK4819_REG_3F, 0}
+};
 
-	BK4819_WriteRegister(BK4819_REG_1F, 0x5454);
-	BK4819_WriteRegister(BK4819_REG_3E, 0xA037);
+void BK4819_Init(void)
+{
+	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
+	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
+	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
+
+	BK4819_WriteRegisters(init_reset_regs, ARRAY_SIZE(init_reset_regs));
+
+	BK4819_SetAGC(0);
+//	BK4819_SetAGC(1);
 
 	gBK4819_GpioOutState = 0x9000;
 
-	BK4819_WriteRegister(BK4819_REG_33, 0x9000);
-	BK4819_WriteRegister(BK4819_REG_3F, 0);
+	BK4819_WriteRegisters(init_regs, ARRAY_SIZE(init_regs));
 }
 
+#ifndef ENABLE_HOST_SIM
+// the host simulator supplies its own register model for these (sim/bk4819.c)
+
 static uint16_t BK4819_ReadU16(void)
 {
 	unsigned int i;
@@ -140,7 +151,7 @@ static uint16_t BK4819_ReadU16(void)
 	return Value;
 }
 
-uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register)
+uint16_t BK4819_ReadRegisterDirect(BK4819_REGISTER_t Register)
 {
 	uint16_t Value;
 
@@ -162,25 +173,55 @@ uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register)
 	return Value;
 }
 
-void BK4819_WriteRegister(BK4819_REGISTER_t Register, uint16_t Data)
+// one SCL half period for the write path, ~0.5us at 48MHz .. SYSTICK_DelayUs(1)
+// actually takes 1 to 2us an edge, which is what made a register write ~80us
+static inline void BK4819_Delay(void)
 {
-	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
-	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
+	unsigned int i;
+	for (i = 0; i < 4; i++)
+		__NOP();
+}
 
-	SYSTICK_DelayUs(1);
+static void BK4819_WriteBits(uint32_t Data, const unsigned int bits)
+{
+	uint32_t data = GPIOC->DATA & ~(1u << GPIOC_PIN_BK4819_SCL);
+	uint32_t mask = 1u << (bits - 1);
 
-	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
-	BK4819_WriteU8(Register);
+	for ( ; mask; mask >>= 1)
+	{
+		if (Data & mask)
+			data |=  (1u << GPIOC_PIN_BK4819_SDA);
+		else
+			data &= ~(1u << GPIOC_PIN_BK4819_SDA);
 
-	SYSTICK_DelayUs(1);
+		GPIOC->DATA = data;
+		BK4819_Delay();
+		GPIOC->DATA = data | (1u << GPIOC_PIN_BK4819_SCL);
+		BK4819_Delay();
+	}
 
-	BK4819_WriteU16(Data);
+	GPIOC->DATA = data;
+	BK4819_Delay();
+}
 
-	SYSTICK_DelayUs(1);
+void BK4819_WriteRegistersDirect(const BK4819_reg_val_t *pList, const unsigned int count)
+{
+	unsigned int i;
 
 	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
-
-	SYSTICK_DelayUs(1);
+	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
+	BK4819_Delay();
+
+	for (i = 0; i < count; i++)
+	{	// the chip latches each register on SCN going high, the idle SCL/SDA
+		// levels in between only need restoring once we're done
+		GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
+		BK4819_Delay();
+		BK4819_WriteBits(pList[i].reg, 8);
+		BK4819_WriteBits(pList[i].val, 16);
+		GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCN);
+		BK4819_Delay();
+	}
 
 	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
 	GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
@@ -188,48 +229,172 @@ void BK4819_WriteRegister(BK4819_REGISTER_t Register, uint16_t Data)
 
 void BK4819_WriteU8(uint8_t Data)
 {
-	unsigned int i;
+	BK4819_WriteBits(Data, 8);
+}
 
-	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
-	for (i = 0; i < 8; i++)
-	{
-		if ((Data & 0x80) == 0)
-			GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
-		else
-			GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
+void BK4819_WriteU16(uint16_t Data)
+{
+	BK4819_WriteBits(Data, 16);
+}
 
-		SYSTICK_DelayUs(1);
-		GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
-		SYSTICK_DelayUs(1);
+#endif
 
-		Data <<= 1;
+// RAM copy of the registers we've written (or read) .. the bus is bit-banged
+// at roughly 80us a register, so reads come from here where we can and writes
+// that wouldn't change anything are dropped
+//
+// registers the chip changes itself (status, indicators, FIFO), strobes and
+// the indexed registers (one address, many internal registers) are never
+// shadowed, they always go out on the bus
 
-		GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
-		SYSTICK_DelayUs(1);
+#define REG_BIT(reg)  (1u << ((reg) & 31u))
+
+static const uint32_t uncached_regs[4] =
+{
+	REG_BIT(BK4819_REG_00) |   // soft reset
+	REG_BIT(BK4819_REG_02) |   // interrupt flags
+	REG_BIT(BK4819_REG_06) |   // indexed AGC table
+	REG_BIT(BK4819_REG_07) |   // indexed CTC1/CTC2/CDCSS
+	REG_BIT(BK4819_REG_08) |   // indexed CDCSS code word
+	REG_BIT(BK4819_REG_09) |   // indexed DTMF coeffs
+	REG_BIT(BK4819_REG_0B) |
+	REG_BIT(BK4819_REG_0C) |
+	REG_BIT(BK4819_REG_0D) |
+	REG_BIT(BK4819_REG_0E),
+
+	0,
+
+	REG_BIT(BK4819_REG_59) |   // FSK control, has FIFO clear strobes
+	REG_BIT(BK4819_REG_5F),    // FSK FIFO
+
+	REG_BIT(BK4819_REG_63) |
+	REG_BIT(BK4819_REG_64) |
+	REG_BIT(BK4819_REG_65) |
+	REG_BIT(0x66)          |
+	REG_BIT(BK4819_REG_67) |
+	REG_BIT(BK4819_REG_68) |
+	REG_BIT(BK4819_REG_69) |
+	REG_BIT(BK4819_REG_6A) |
+	REG_BIT(BK4819_REG_6F)
+};
+
+static uint16_t shadow_regs[128];
+static uint32_t shadow_valid[4];
+
+uint32_t g_bk4819_bus_cycles_saved;
+
+static inline bool BK4819_IsCached(const unsigned int reg)
+{
+	return (uncached_regs[reg >> 5] & REG_BIT(reg)) == 0;
+}
+
+uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register)
+{
+	const unsigned int reg = Register & 0x7Fu;
+	uint16_t           Value;
+
+	if (!BK4819_IsCached(reg))
+	{
+		Value = BK4819_ReadRegisterDirect(Register);
+		#ifdef ENABLE_BUS_TRACE
+			TRACE_Log(TRACE_BK4819_READ, reg, Value);
+		#endif
+		return Value;
 	}
+
+	if (shadow_valid[reg >> 5] & REG_BIT(reg))
+	{
+		g_bk4819_bus_cycles_saved++;
+		#ifdef ENABLE_BUS_TRACE
+			TRACE_Log(TRACE_BK4819_READ_SHADOW, reg, shadow_regs[reg]);
+		#endif
+		return shadow_regs[reg];
+	}
+
+	Value = BK4819_ReadRegisterDirect(Register);
+	#ifdef ENABLE_BUS_TRACE
+		TRACE_Log(TRACE_BK4819_READ, reg, Value);
+	#endif
+
+	shadow_regs[reg]        = Value;
+	shadow_valid[reg >> 5] |= REG_BIT(reg);
+
+	return Value;
 }
 
-void BK4819_WriteU16(uint16_t Data)
+// returns true if the write has to go out on the bus
+static bool BK4819_ShadowWrite(const BK4819_REGISTER_t Register, const uint16_t Data)
 {
-	unsigned int i;
+	const unsigned int reg = Register & 0x7Fu;
 
-	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
-	for (i = 0; i < 16; i++)
+	if (!BK4819_IsCached(reg))
 	{
-		if ((Data & 0x8000) == 0)
-			GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
-		else
-			GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SDA);
+		if (reg == BK4819_REG_00 && (Data & 0x8000u))
+		{	// soft reset, everything is going back to defaults
+			unsigned int i;
+			for (i = 0; i < ARRAY_SIZE(shadow_valid); i++)
+				shadow_valid[i] = 0;
+		}
+		#ifdef ENABLE_BUS_TRACE
+			TRACE_Log(TRACE_BK4819_WRITE, reg, Data);
+		#endif
+		return true;
+	}
 
-		SYSTICK_DelayUs(1);
-		GPIO_SetBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
+	if ((shadow_valid[reg >> 5] & REG_BIT(reg)) && shadow_regs[reg] == Data)
+	{
+		g_bk4819_bus_cycles_saved++;
+		#ifdef ENABLE_BUS_TRACE
+			TRACE_Log(TRACE_BK4819_WRITE_SKIPPED, reg, Data);
+		#endif
+		return false;
+	}
 
-		Data <<= 1;
+	shadow_regs[reg]        = Data;
+	shadow_valid[reg >> 5] |= REG_BIT(reg);
 
-		SYSTICK_DelayUs(1);
-		GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_BK4819_SCL);
-		SYSTICK_DelayUs(1);
+	#ifdef ENABLE_BUS_TRACE
+		TRACE_Log(TRACE_BK4819_WRITE, reg, Data);
+	#endif
+
+	return true;
+}
+
+
+void BK4819_WriteRegisterDirect(BK4819_REGISTER_t Register, uint16_t Data)
+{
+	const BK4819_reg_val_t reg_val = {Register, Data};
+	BK4819_WriteRegistersDirect(&reg_val, 1);
+}
+
+void BK4819_WriteRegister(BK4819_REGISTER_t Register, uint16_t Data)
+{
+	if (BK4819_ShadowWrite(Register, Data))
+		BK4819_WriteRegisterDirect(Register, Data);
+}
+
+void BK4819_WriteRegisters(const BK4819_reg_val_t *pList, const unsigned int count)
+{
+	BK4819_reg_val_t pending[16];
+	unsigned int     num_pending = 0;
+	unsigned int     i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (!BK4819_ShadowWrite(pList[i].reg, pList[i].val))
+			continue;
+
+		pending[num_pending++] = pList[i];
+
+		if (num_pending >= ARRAY_SIZE(pending))
+		{
+			BK4819_WriteRegistersDirect(pending, num_pending);
+			num_pending = 0;
+		}
 	}
+
+	if (num_pending > 0)
+		BK4819_WriteRegistersDirect(pending, num_pending);
 }
 
 void BK4819_SetAGC(uint8_t Value)
@@ -274,22 +439,25 @@ void BK4819_SetAGC(uint8_t Value)
 		//         1 = -27dB
 		//         0 = -33dB
 		//
-		BK4819_WriteRegister(BK4819_REG_13, (3u << 8) | (2u << 5) | (3u << 3) | (6u << 0));  // 000000 11 101 11 110
+		static const BK4819_reg_val_t agc_regs[] =
+		{
+			{BK4819_REG_13, (3u << 8) | (2u << 5) | (3u << 3) | (6u << 0)},  // 000000 11 101 11 110
+
+			{BK4819_REG_12, 0x037B},  // 000000 11 011 11 011
+			{BK4819_REG_11, 0x027B},  // 000000 10 011 11 011
+			{BK4819_REG_10, 0x007A},  // 000000 00 011 11 010
+			{BK4819_REG_14, 0x0019},  // 000000 00 000 11 001
 
-		BK4819_WriteRegister(BK4819_REG_12, 0x037B);  // 000000 11 011 11 011
-		BK4819_WriteRegister(BK4819_REG_11, 0x027B);  // 000000 10 011 11 011
-		BK4819_WriteRegister(BK4819_REG_10, 0x007A);  // 000000 00 011 11 010
-		BK4819_WriteRegister(BK4819_REG_14, 0x0019);  // 000000 00 000 11 001
+			{BK4819_REG_49, 0x2A38},
+			{BK4819_REG_7B, 0x8420}
+		};
 
-		BK4819_WriteRegister(BK4819_REG_49, 0x2A38);
-		BK4819_WriteRegister(BK4819_REG_7B, 0x8420);
+		BK4819_WriteRegisters(agc_regs, ARRAY_SIZE(agc_regs));
 	}
 	else
 	if (Value == 1)
 	{	// what does this do ???
 
-		unsigned int i;
-
 		// REG_10
 		//
 		// 0x0038 Rx AGC Gain Table[0]. (Index Max->Min is 3,2,1,0,-1)
@@ -328,22 +496,33 @@ void BK4819_SetAGC(uint8_t Value)
 		//         1 = -27dB
 		//         0 = -33dB
 		//
-		BK4819_WriteRegister(BK4819_REG_13, (3u << 8) | (2u << 5) | (3u << 3) | (6u << 0));
+		static const BK4819_reg_val_t agc_regs[] =
+		{
+			{BK4819_REG_13, (3u << 8) | (2u << 5) | (3u << 3) | (6u << 0)},
 
-		BK4819_WriteRegister(BK4819_REG_12, 0x037C);  // 000000 11 011 11 100
-		BK4819_WriteRegister(BK4819_REG_11, 0x027B);  // 000000 10 011 11 011
-		BK4819_WriteRegister(BK4819_REG_10, 0x007A);  // 000000 00 011 11 010
-		BK4819_WriteRegister(BK4819_REG_14, 0x0018);  // 000000 00 000 11 000
+			{BK4819_REG_12, 0x037C},  // 000000 11 011 11 100
+			{BK4819_REG_11, 0x027B},  // 000000 10 011 11 011
+			{BK4819_REG_10, 0x007A},  // 000000 00 011 11 010
+			{BK4819_REG_14, 0x0018},  // 000000 00 000 11 000
 
-		BK4819_WriteRegister(BK4819_REG_49, 0x2A38);
-		BK4819_WriteRegister(BK4819_REG_7B, 0x318C);
+			{BK4819_REG_49, 0x2A38},
+			{BK4819_REG_7B, 0x318C},
 
-		BK4819_WriteRegister(BK4819_REG_7C, 0x595E);
-		BK4819_WriteRegister(BK4819_REG_20, 0x8DEF);
+			{BK4819_REG_7C, 0x595E},
+			{BK4819_REG_20, 0x8DEF},
 
-		for (i = 0; i < 8; i++)
 			// Bug? The bit 0x2000 below overwrites the (i << 13)
-			BK4819_WriteRegister(BK4819_REG_06, ((i << 13) | 0x2500u) + 0x036u);
+			{BK4819_REG_06, ((0u << 13) | 0x2500u) + 0x036u},
+			{BK4819_REG_06, ((1u << 13) | 0x2500u) + 0x036u},
+			{BK4819_REG_06, ((2u << 13) | 0x2500u) + 0x036u},
+			{BK4819_REG_06, ((3u << 13) | 0x2500u) + 0x036u},
+			{BK4819_REG_06, ((4u << 13) | 0x2500u) + 0x036u},
+			{BK4819_REG_06, ((5u << 13) | 0x2500u) + 0x036u},
+			{BK4819_REG_06, ((6u << 13) | 0x2500u) + 0x036u},
+			{BK4819_REG_06, ((7u << 13) | 0x2500u) + 0x036u}
+		};
+
+		BK4819_WriteRegisters(agc_regs, ARRAY_SIZE(agc_regs));
 	}
 }
 
@@ -592,94 +771,75 @@ void BK4819_SetFilterBandwidth(const BK4819_filter_bandwidth_t Bandwidth, const
 	//
 	// <1:0>   0 ???
 
-	uint16_t val;
-
-	switch (Bandwidth)
+	// [bandwidth][weak_no_different]
+	static const uint16_t bw_regs[3][2] =
 	{
-		default:
-		case BK4819_FILTER_BW_WIDE:	// 25kHz
-			if (weak_no_different)
-			{	// make the RX bandwidth the same with weak signals
-				val =
-					(0u << 15) |     //  0
-					(4u << 12) |     // *3 RF filter bandwidth
-					(4u <<  9) |     // *0 RF filter bandwidth when signal is weak
-					(6u <<  6) |     // *0 AFTxLPF2 filter Band Width
-					(2u <<  4) |     //  2 BW Mode Selection
-					(1u <<  3) |     //  1
-					(0u <<  2) |     //  0 Gain after FM Demodulation
-					(0u <<  0);      //  0
-			}
-			else
-			{	// with weak RX signals the RX bandwidth is reduced
-				val =                // 0x3028);         // 0 011 000 000 10 1 0 00
-					(0u << 15) |     //  0
-					(4u << 12) |     // *3 RF filter bandwidth
-					(2u <<  9) |     // *0 RF filter bandwidth when signal is weak
-					(6u <<  6) |     // *0 AFTxLPF2 filter Band Width
-					(2u <<  4) |     //  2 BW Mode Selection
-					(1u <<  3) |     //  1
-					(0u <<  2) |     //  0 Gain after FM Demodulation
-					(0u <<  0);      //  0
-			}
-			break;
-
-		case BK4819_FILTER_BW_NARROW:	// 12.5kHz
-			if (weak_no_different)
-			{
-				val =
-					(0u << 15) |     //  0
-					(4u << 12) |     // *4 RF filter bandwidth
-					(4u <<  9) |     // *0 RF filter bandwidth when signal is weak
-					(0u <<  6) |     // *1 AFTxLPF2 filter Band Width
-					(0u <<  4) |     //  0 BW Mode Selection
-					(1u <<  3) |     //  1
-					(0u <<  2) |     //  0 Gain after FM Demodulation
-					(0u <<  0);      //  0
-			}
-			else
-			{
-				val =                // 0x4048);        // 0 100 000 001 00 1 0 00
-					(0u << 15) |     //  0
-					(4u << 12) |     // *4 RF filter bandwidth
-					(2u <<  9) |     // *0 RF filter bandwidth when signal is weak
-					(0u <<  6) |     // *1 AFTxLPF2 filter Band Width
-					(0u <<  4) |     //  0 BW Mode Selection
-					(1u <<  3) |     //  1
-					(0u <<  2) |     //  0 Gain after FM Demodulation
-					(0u <<  0);      //  0
-			}
-			break;
-
-		case BK4819_FILTER_BW_NARROWER:	// 6.25kHz
-			if (weak_no_different)
-			{
-				val =
-					(0u << 15) |     //  0
-					(3u << 12) |     //  3 RF filter bandwidth
-					(3u <<  9) |     // *0 RF filter bandwidth when signal is weak
-					(1u <<  6) |     //  1 AFTxLPF2 filter Band Width
-					(1u <<  4) |     //  1 BW Mode Selection
-					(1u <<  3) |     //  1
-					(0u <<  2) |     //  0 Gain after FM Demodulation
-					(0u <<  0);      //  0
-			}
-			else
-			{
-				val =
-					(0u << 15) |     //  0
-					(3u << 12) |     //  3 RF filter bandwidth
-					(0u <<  9) |     //  0 RF filter bandwidth when signal is weak
-					(1u <<  6) |     //  1 AFTxLPF2 filter Band Width
-					(1u <<  4) |     //  1 BW Mode Selection
-					(1u <<  3) |     //  1
-					(0u <<  2) |     //  1 Gain after FM Demodulation
-					(0u <<  0);      //  0
-			}
-			break;
-	}
-
-	BK4819_WriteRegister(BK4819_REG_43, val);
+		{	// 25kHz
+			// with weak RX signals the RX bandwidth is reduced
+			// 0x3028);         // 0 011 000 000 10 1 0 00
+			(0u << 15) |     //  0
+			(4u << 12) |     // *3 RF filter bandwidth
+			(2u <<  9) |     // *0 RF filter bandwidth when signal is weak
+			(6u <<  6) |     // *0 AFTxLPF2 filter Band Width
+			(2u <<  4) |     //  2 BW Mode Selection
+			(1u <<  3) |     //  1
+			(0u <<  2) |     //  0 Gain after FM Demodulation
+			(0u <<  0),      //  0
+
+			// make the RX bandwidth the same with weak signals
+			(0u << 15) |     //  0
+			(4u << 12) |     // *3 RF filter bandwidth
+			(4u <<  9) |     // *0 RF filter bandwidth when signal is weak
+			(6u <<  6) |     // *0 AFTxLPF2 filter Band Width
+			(2u <<  4) |     //  2 BW Mode Selection
+			(1u <<  3) |     //  1
+			(0u <<  2) |     //  0 Gain after FM Demodulation
+			(0u <<  0)       //  0
+		},
+		{	// 12.5kHz
+			// 0x4048);        // 0 100 000 001 00 1 0 00
+			(0u << 15) |     //  0
+			(4u << 12) |     // *4 RF filter bandwidth
+			(2u <<  9) |     // *0 RF filter bandwidth when signal is weak
+			(0u <<  6) |     // *1 AFTxLPF2 filter Band Width
+			(0u <<  4) |     //  0 BW Mode Selection
+			(1u <<  3) |     //  1
+			(0u <<  2) |     //  0 Gain after FM Demodulation
+			(0u <<  0),      //  0
+
+			(0u << 15) |     //  0
+			(4u << 12) |     // *4 RF filter bandwidth
+			(4u <<  9) |     // *0 RF filter bandwidth when signal is weak
+			(0u <<  6) |     // *1 AFTxLPF2 filter Band Width
+			(0u <<  4) |     //  0 BW Mode Selection
+			(1u <<  3) |     //  1
+			(0u <<  2) |     //  0 Gain after FM Demodulation
+			(0u <<  0)       //  0
+		},
+		{	// 6.25kHz
+			(0u << 15) |     //  0
+			(3u << 12) |     //  3 RF filter bandwidth
+			(0u <<  9) |     //  0 RF filter bandwidth when signal is weak
+			(1u <<  6) |     //  1 AFTxLPF2 filter Band Width
+			(1u <<  4) |     //  1 BW Mode Selection
+			(1u <<  3) |     //  1
+			(0u <<  2) |     //  1 Gain after FM Demodulation
+			(0u <<  0),      //  0
+
+			(0u << 15) |     //  0
+			(3u << 12) |     //  3 RF filter bandwidth
+			(3u <<  9) |     // *0 RF filter bandwidth when signal is weak
+			(1u <<  6) |     //  1 AFTxLPF2 filter Band Width
+			(1u <<  4) |     //  1 BW Mode Selection
+			(1u <<  3) |     //  1
+			(0u <<  2) |     //  0 Gain after FM Demodulation
+			(0u <<  0)       //  0
+		}
+	};
+
+	const unsigned int bw = (Bandwidth <= BK4819_FILTER_BW_NARROWER) ? Bandwidth : BK4819_FILTER_BW_WIDE;
+
+	BK4819_WriteRegister(BK4819_REG_43, bw_regs[bw][weak_no_different ? 1 : 0]);
 }
 
 void BK4819_SetupPowerAmplifier(const uint8_t bias, const uint32_t frequency)
@@ -708,8 +868,12 @@ void BK4819_SetupPowerAmplifier(const uint8_t bias, const uint32_t frequency)
 
 void BK4819_SetFrequency(uint32_t Frequency)
 {
-	BK4819_WriteRegister(BK4819_REG_38, (Frequency >>  0) & 0xFFFF);
-	BK4819_WriteRegister(BK4819_REG_39, (Frequency >> 16) & 0xFFFF);
+	const BK4819_reg_val_t regs[] =
+	{
+		{BK4819_REG_38, (Frequency >>  0) & 0xFFFF},
+		{BK4819_REG_39, (Frequency >> 16) & 0xFFFF}
+	};
+	BK4819_WriteRegisters(regs, ARRAY_SIZE(regs));
 }
 
 void BK4819_SetupSquelch(
@@ -720,79 +884,84 @@ void BK4819_SetupSquelch(
 		uint8_t squelch_close_glitch_thresh,
 		uint8_t squelch_open_glitch_thresh)
 {
-	// REG_70
-	//
-	// <15>   0 Enable TONE1
-	//        1 = Enable
-	//        0 = Disable
-	//
-	// <14:8> 0 TONE1 tuning gain
-	//        0 ~ 127
-	//
-	// <7>    0 Enable TONE2
-	//        1 = Enable
-	//        0 = Disable
-	//
-	// <6:0>  0 TONE2/FSK tuning gain
-	//        0 ~ 127
-	//
-	BK4819_WriteRegister(BK4819_REG_70, 0);
+	const BK4819_reg_val_t regs[] =
+	{
+		// REG_70
+		//
+		// <15>   0 Enable TONE1
+		//        1 = Enable
+		//        0 = Disable
+		//
+		// <14:8> 0 TONE1 tuning gain
+		//        0 ~ 127
+		//
+		// <7>    0 Enable TONE2
+		//        1 = Enable
+		//        0 = Disable
+		//
+		// <6:0>  0 TONE2/FSK tuning gain
+		//        0 ~ 127
+		//
+		{BK4819_REG_70, 0},
 
-	// Glitch threshold for Squelch = close
-	//
-	// 0 ~ 255
-	//
-	BK4819_WriteRegister(BK4819_REG_4D, 0xA000 | squelch_close_glitch_thresh);
+		// Glitch threshold for Squelch = close
+		//
+		// 0 ~ 255
+		//
+		{BK4819_REG_4D, 0xA000 | squelch_close_glitch_thresh},
 
-	// REG_4E
-	//
-	// <15:14> 1 ???
-	//
-	// <13:11> 5 Squelch = open  Delay Setting
-	//         0 ~ 7
-	//
-	// <10:9>  7 Squelch = close Delay Setting
-	//         0 ~ 3
-	//
-	// <8>     0 ???
-	//
-	// <7:0>   8 Glitch threshold for Squelch = open
-	//         0 ~ 255
-	//
-	BK4819_WriteRegister(BK4819_REG_4E,  // 01 101 11 1 00000000
-	#ifndef ENABLE_FASTER_CHANNEL_SCAN
-		// original (*)
-		(1u << 14) |                  //  1 ???
-		(3u << 11) |                  // *5  squelch = open  delay .. 0 ~ 7
-		(2u <<  9) |                  // *3  squelch = close delay .. 0 ~ 3
-		squelch_open_glitch_thresh);     //  0 ~ 255
-	#else
-		// faster (but twitchier)
-		(1u << 14) |                  //  1 ???
-		(2u << 11) |                  // *5  squelch = open  delay .. 0 ~ 7
-		(1u <<  9) |                  // *3  squelch = close delay .. 0 ~ 3
-		squelch_open_glitch_thresh);     //  0 ~ 255
-	#endif
+		// REG_4E
+		//
+		// <15:14> 1 ???
+		//
+		// <13:11> 5 Squelch = open  Delay Setting
+		//         0 ~ 7
+		//
+		// <10:9>  7 Squelch = close Delay Setting
+		//         0 ~ 3
+		//
+		// <8>     0 ???
+		//
+		// <7:0>   8 Glitch threshold for Squelch = open
+		//         0 ~ 255
+		//
+		{BK4819_REG_4E,  // 01 101 11 1 00000000
+		#ifndef ENABLE_FASTER_CHANNEL_SCAN
+			// original (*)
+			(1u << 14) |                  //  1 ???
+			(3u << 11) |                  // *5  squelch = open  delay .. 0 ~ 7
+			(2u <<  9) |                  // *3  squelch = close delay .. 0 ~ 3
+			squelch_open_glitch_thresh},     //  0 ~ 255
+		#else
+			// faster (but twitchier)
+			(1u << 14) |                  //  1 ???
+			(2u << 11) |                  // *5  squelch = open  delay .. 0 ~ 7
+			(1u <<  9) |                  // *3  squelch = close delay .. 0 ~ 3
+			squelch_open_glitch_thresh},     //  0 ~ 255
+		#endif
+
+		// REG_4F
+		//
+		// <14:8> 47 Ex-noise threshold for Squelch = close
+		//        0 ~ 127
+		//
+		// <7>    ???
+		//
+		// <6:0>  46 Ex-noise threshold for Squelch = open
+		//        0 ~ 127
+		//
+		{BK4819_REG_4F, ((uint16_t)squelch_close_noise_thresh << 8) | squelch_open_noise_thresh},
 
-	// REG_4F
-	//
-	// <14:8> 47 Ex-noise threshold for Squelch = close
-	//        0 ~ 127
-	//
-	// <7>    ???
-	//
-	// <6:0>  46 Ex-noise threshold for Squelch = open
-	//        0 ~ 127
-	//
-	BK4819_WriteRegister(BK4819_REG_4F, ((uint16_t)squelch_close_noise_thresh << 8) | squelch_open_noise_thresh);
+		// REG_78
+		//
+		// <15:8> 72 RSSI threshold for Squelch = open    0.5dB/step
+		//
+		// <7:0>  70 RSSI threshold for Squelch = close   0.5dB/step
+		//
+		{BK4819_REG_78, ((uint16_t)squelch_open_rssi_thresh   << 8) | squelch_close_rssi_thresh}
+	};
 
-	// REG_78
-	//
-	// <15:8> 72 RSSI threshold for Squelch = open    0.5dB/step
-	//
-	// <7:0>  70 RSSI threshold for Squelch = close   0.5dB/step
-	//
-	BK4819_WriteRegister(BK4819_REG_78, ((uint16_t)squelch_open_rssi_thresh   << 8) | squelch_close_rssi_thresh);
+	BK4819_WriteRegisters(regs, ARRAY_SIZE(regs));
 
 	BK4819_SetAF(BK4819_AF_MUTE);
 
@@ -810,55 +979,54 @@ void BK4819_SetAF(BK4819_af_type_t AF)
 
 void BK4819_RX_TurnOn(void)
 {
-	// DSP Voltage Setting = 1
-	// ANA LDO = 2.7v
-	// VCO LDO = 2.7v
-	// RF LDO  = 2.7v
-	// PLL LDO = 2.7v
-	// ANA LDO bypass
-	// VCO LDO bypass
-	// RF LDO  bypass
-	// PLL LDO bypass
-	// Reserved bit is 1 instead of 0
-	// Enable  DSP
-	// Enable  XTAL
-	// Enable  Band Gap
-	//
-	BK4819_WriteRegister(BK4819_REG_37, 0x1F0F);  // 0001 1111 0000 1111
-
-	// Turn off everything
-	BK4819_WriteRegister(BK4819_REG_30, 0);
+	static const BK4819_reg_val_t regs[] =
+	{
+		// DSP Voltage Setting = 1
+		// ANA LDO = 2.7v
+		// VCO LDO = 2.7v
+		// RF LDO  = 2.7v
+		// PLL LDO = 2.7v
+		// ANA LDO bypass
+		// VCO LDO bypass
+		// RF LDO  bypass
+		// PLL LDO bypass
+		// Reserved bit is 1 instead of 0
+		// Enable  DSP
+		// Enable  XTAL
+		// Enable  Band Gap
+		//
+		{BK4819_REG_37, 0x1F0F},  // 0001 1111 0000 1111
+
+		// Turn off everything
+		{BK4819_REG_30, 0},
+
+		// Enable  VCO Calibration
+		// Enable  RX Link
+		// Enable  AF DAC
+		// Enable  PLL/VCO
+		// Disable PA Gain
+		// Disable MIC ADC
+		// Disable TX DSP
+		// Enable  RX DSP
+		//
+		{BK4819_REG_30, 0xbff1}   // 1 0 1111 1 1 1111 0 0 0 1
+	};
 
-	// Enable  VCO Calibration
-	// Enable  RX Link
-	// Enable  AF DAC
-	// Enable  PLL/VCO
-	// Disable PA Gain
-	// Disable MIC ADC
-	// Disable TX DSP
-	// Enable  RX DSP
-	//
-	BK4819_WriteRegister(BK4819_REG_30, 0xbff1); // 1 0 1111 1 1 1111 0 0 0 1
+	BK4819_WriteRegisters(regs, ARRAY_SIZE(regs));
 }
 
 void BK4819_PickRXFilterPathBasedOnFrequency(uint32_t Frequency)
 {
+	// both filter pins in the one REG_33 write
+	gBK4819_GpioOutState &= ~((0x40u >> BK4819_GPIO2_PIN30) | (0x40u >> BK4819_GPIO3_PIN31));
+
 	if (Frequency < 28000000)
-	{
-		BK4819_set_GPIO_pin(BK4819_GPIO2_PIN30, true);
-		BK4819_set_GPIO_pin(BK4819_GPIO3_PIN31, false);
-	}
-	else
-	if (Frequency == 0xFFFFFFFF)
-	{
-		BK4819_set_GPIO_pin(BK4819_GPIO2_PIN30, false);
-		BK4819_set_GPIO_pin(BK4819_GPIO3_PIN31, false);
-	}
+		gBK4819_GpioOutState |= 0x40u >> BK4819_GPIO2_PIN30;
 	else
-	{
-		BK4819_set_GPIO_pin(BK4819_GPIO2_PIN30, false);
-		BK4819_set_GPIO_pin(BK4819_GPIO3_PIN31, true);
-	}
+	if (Frequency != 0xFFFFFFFF)
+		gBK4819_GpioOutState |= 0x40u >> BK4819_GPIO3_PIN31;
+
+	BK4819_WriteRegister(BK4819_REG_33, gBK4819_GpioOutState);
 }
 
 void BK4819_DisableScramble(void)
@@ -1675,6 +1843,60 @@ uint8_t BK4819_GetDTMF_5TONE_Code(void)
 	return (BK4819_ReadRegister(BK4819_REG_0B) >> 8) & 0x0F;
 }
 
+// interrupt requests waiting to be handled, oldest first
+static BK4819_event_t event_queue[BK4819_EVENT_QUEUE_SIZE];
+static unsigned int   event_read;
+static unsigned int   event_count;
+
+// move the chip's pending interrupt requests into the event queue,
+// returns how many are waiting
+//
+// the IRQ output isn't wired to the MCU, so this is still a poll of REG_0C,
+// but it's skipped altogether while no interrupt sources are enabled (REG_3F
+// comes from the register shadow, no bus cycles)
+unsigned int BK4819_FetchEvents(void)
+{
+	if (BK4819_ReadRegister(BK4819_REG_3F) == 0)
+		return event_count;
+
+	while (event_count < ARRAY_SIZE(event_queue) && (BK4819_ReadRegister(BK4819_REG_0C) & 1u))
+	{
+		BK4819_event_t *pEvent = &event_queue[(event_read + event_count) % ARRAY_SIZE(event_queue)];
+
+		// reset the interrupt ?
+		BK4819_WriteRegister(BK4819_REG_02, 0);
+
+		// fetch the interrupt status bits
+		pEvent->status = BK4819_ReadRegister(BK4819_REG_02);
+
+		if (pEvent->status & BK4819_REG_02_DTMF_5TONE_FOUND)
+			pEvent->code = BK4819_GetDTMF_5TONE_Code();
+
+		if (pEvent->status & BK4819_REG_02_FSK_FIFO_ALMOST_FULL)
+		{	// the request won't go away till the FIFO's been read
+			unsigned int i;
+			for (i = 0; i < ARRAY_SIZE(pEvent->data); i++)
+				pEvent->data[i] = BK4819_ReadRegister(BK4819_REG_5F);
+		}
+
+		event_count++;
+	}
+
+	return event_count;
+}
+
+bool BK4819_GetEvent(BK4819_event_t *pEvent)
+{
+	if (event_count == 0)
+		return false;
+
+	*pEvent    = event_queue[event_read];
+	event_read = (event_read + 1) % ARRAY_SIZE(event_queue);
+	event_count--;
+
+	return true;
+}
+
 uint8_t BK4819_get_CDCSS_code_type(void)
 {
 	return (BK4819_ReadRegister(BK4819_REG_0C) >> 14) & 3u;
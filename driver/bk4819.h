@@ -59,11 +59,31 @@ enum BK4819_CSS_scan_result_e
 };
 typedef enum BK4819_CSS_scan_result_e BK4819_CSS_scan_result_t;
 
-extern bool g_rx_idle_mode;
+typedef struct {
+	BK4819_REGISTER_t reg;
+	uint16_t          val;
+} BK4819_reg_val_t;
+
+// one interrupt request, fetched and cleared by BK4819_FetchEvents() .. anything
+// that has to be read off the chip while the request is latched comes with it
+typedef struct {
+	uint16_t status;     // BK4819_REG_02_xxx bits
+	uint16_t data[4];    // the FSK FIFO words
+	uint8_t  code;       // the DTMF/5-tone code
+} BK4819_event_t;
+
+#define BK4819_EVENT_QUEUE_SIZE  4
+
+extern bool     g_rx_idle_mode;
+extern uint32_t g_bk4819_bus_cycles_saved;   // register accesses the shadow saved us from doing
 
 void     BK4819_Init(void);
 uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register);
 void     BK4819_WriteRegister(BK4819_REGISTER_t Register, uint16_t Data);
+uint16_t BK4819_ReadRegisterDirect(BK4819_REGISTER_t Register);              // bypass the register shadow
+void     BK4819_WriteRegisterDirect(BK4819_REGISTER_t Register, uint16_t Data);
+void     BK4819_WriteRegisters(const BK4819_reg_val_t *pList, const unsigned int count);
+void     BK4819_WriteRegistersDirect(const BK4819_reg_val_t *pList, const unsigned int count);
 void     BK4819_WriteU8(uint8_t Data);
 void     BK4819_WriteU16(uint16_t Data);
 
@@ -146,6 +166,8 @@ void     BK4819_Disable(void);
 void     BK4819_StopScan(void);
 
 uint8_t  BK4819_GetDTMF_5TONE_Code(void);
+unsigned int BK4819_FetchEvents(void);
+bool     BK4819_GetEvent(BK4819_event_t *pEvent);
 
 uint8_t  BK4819_get_CDCSS_code_type(void);
 uint8_t  BK4819_GetCTCShift(void);
@@ -14,11 +14,39 @@
  *     limitations under the License.
  */
 
+#include <string.h>
+
 #include "driver/eeprom.h"
-#include "driver/i2c.h"
-#include "driver/system.h"
+#ifdef ENABLE_BUS_TRACE
+	#include "helper/trace.h"
+#endif
+#ifndef ENABLE_HOST_SIM
+	#include "driver/i2c.h"
+#endif
 
-void EEPROM_ReadBuffer(uint16_t Address, void *pBuffer, uint8_t Size)
+// write-behind queue .. 8 byte blocks waiting to be programmed, oldest first
+typedef struct {
+	uint16_t addr;
+	uint8_t  data[8];
+} eeprom_block_t;
+
+uint16_t              g_eeprom_direct_writes;
+
+#define EEPROM_WRITE_LOG_SIZE  4   // the last few direct writes
+
+static struct {
+	uint16_t addr;
+	uint16_t size;
+} eeprom_write_log[EEPROM_WRITE_LOG_SIZE];
+
+static eeprom_block_t eeprom_queue[EEPROM_QUEUE_SIZE];
+static unsigned int   eeprom_queue_count;
+static bool           eeprom_busy;          // a page is being programmed
+
+#ifndef ENABLE_HOST_SIM
+// the host simulator supplies its own chip model for these (sim/eeprom.c)
+
+void EEPROM_ReadBufferDirect(uint16_t Address, void *pBuffer, unsigned int Size)
 {
 	I2C_Start();
 
@@ -36,7 +64,7 @@ void EEPROM_ReadBuffer(uint16_t Address, void *pBuffer, uint8_t Size)
 	I2C_Stop();
 }
 
-void EEPROM_WriteBuffer(uint16_t Address, const void *pBuffer)
+void EEPROM_WritePageDirect(uint16_t Address, const void *pBuffer, unsigned int Size)
 {
 	I2C_Start();
 
@@ -45,9 +73,233 @@ void EEPROM_WriteBuffer(uint16_t Address, const void *pBuffer)
 	I2C_Write((Address >> 8) & 0xFF);
 	I2C_Write((Address >> 0) & 0xFF);
 
-	I2C_WriteBuffer(pBuffer, 8);
+	I2C_WriteBuffer(pBuffer, Size);
 
 	I2C_Stop();
+}
+
+// the EEPROM doesn't ACK its address while it's busy programming a page
+// (typically 3 ~ 5ms)
+bool EEPROM_IsBusyDirect(void)
+{
+	int ack;
+
+	I2C_Start();
+	ack = I2C_Write(0xA0);
+	I2C_Stop();
+
+	return (ack != 0) ? true : false;
+}
+
+#endif
+
+static void EEPROM_WaitForWrite(void)
+{
+	unsigned int i;
+
+	if (!eeprom_busy)
+		return;
+
+	for (i = 0; i < 500 && EEPROM_IsBusyDirect(); i++)   // 500 x ~50us
+	{
+	}
+
+	eeprom_busy = false;
+}
+
+static void EEPROM_RemoveBlock(const unsigned int index)
+{
+	eeprom_queue_count--;
+	memmove(&eeprom_queue[index], &eeprom_queue[index + 1], (eeprom_queue_count - index) * sizeof(eeprom_queue[0]));
+}
+
+// start programming the page holding the oldest queued block, taking every
+// queued block that runs on from it within that page in the same write
+static void EEPROM_StartNextPage(void)
+{
+	const unsigned int page = eeprom_queue[0].addr / EEPROM_PAGE_SIZE;
+	uint8_t            buf[EEPROM_PAGE_SIZE];
+	uint16_t           addr = eeprom_queue[0].addr;
+	unsigned int       len  = 0;
+	unsigned int       max;
+	unsigned int       i;
+
+	// lowest queued address in the page
+	for (i = 1; i < eeprom_queue_count; i++)
+		if (eeprom_queue[i].addr < addr && (eeprom_queue[i].addr / EEPROM_PAGE_SIZE) == page)
+			addr = eeprom_queue[i].addr;
+
+	max = EEPROM_PAGE_SIZE - (addr % EEPROM_PAGE_SIZE);
+
+	for (i = 0; i < eeprom_queue_count && len < max; )
+	{
+		if (eeprom_queue[i].addr != (addr + len))
+		{
+			i++;
+			continue;
+		}
+
+		memcpy(&buf[len], eeprom_queue[i].data, 8);
+		len += 8;
+
+		EEPROM_RemoveBlock(i);
+		i = 0;   // the next block may be further back in the queue
+	}
+
+	EEPROM_WritePageDirect(addr, buf, len);
+	eeprom_busy = true;
+
+	#ifdef ENABLE_BUS_TRACE
+		TRACE_Log(TRACE_EEPROM_WRITE, addr, len);
+	#endif
+}
+
+void EEPROM_ReadBuffer(uint16_t Address, void *pBuffer, uint8_t Size)
+{
+	uint8_t     *pData = (uint8_t *)pBuffer;
+	unsigned int i;
+
+	EEPROM_WaitForWrite();
+
+	EEPROM_ReadBufferDirect(Address, pBuffer, Size);
+	#ifdef ENABLE_BUS_TRACE
+		TRACE_Log(TRACE_EEPROM_READ, Address, Size);
+	#endif
+
+	// anything still waiting in the queue is newer than what's in the chip
+	for (i = 0; i < eeprom_queue_count; i++)
+	{
+		const eeprom_block_t *pBlock = &eeprom_queue[i];
+		unsigned int          k;
+
+		if (pBlock->addr >= (Address + Size) || (pBlock->addr + 8) <= Address)
+			continue;
+
+		for (k = 0; k < 8; k++)
+			if ((pBlock->addr + k) >= Address && (pBlock->addr + k) < (Address + Size))
+				pData[pBlock->addr + k - Address] = pBlock->data[k];
+	}
+}
+
+void EEPROM_Write(uint16_t Address, const void *pBuffer, unsigned int Size)
+{
+	const uint8_t *pData = (const uint8_t *)pBuffer;
+	unsigned int   i;
+
+	eeprom_write_log[g_eeprom_direct_writes % EEPROM_WRITE_LOG_SIZE].addr = Address;
+	eeprom_write_log[g_eeprom_direct_writes % EEPROM_WRITE_LOG_SIZE].size = (Size < 0xFFFF) ? Size : 0xFFFF;
+	g_eeprom_direct_writes++;
+
+	EEPROM_WaitForWrite();
+
+	// keep any queued blocks we overlap in step, else they'd later put the old data back
+	for (i = 0; i < eeprom_queue_count; i++)
+	{
+		eeprom_block_t *pBlock = &eeprom_queue[i];
+		unsigned int    k;
+
+		if (pBlock->addr >= (Address + Size) || (pBlock->addr + 8) <= Address)
+			continue;
+
+		for (k = 0; k < 8; k++)
+			if ((pBlock->addr + k) >= Address && (pBlock->addr + k) < (Address + Size))
+				pBlock->data[k] = pData[pBlock->addr + k - Address];
+	}
+
+	while (Size > 0)
+	{	// a write can't cross a page boundary, it'd wrap around within the page
+		unsigned int len = EEPROM_PAGE_SIZE - (Address % EEPROM_PAGE_SIZE);
+		if (len > Size)
+			len = Size;
+
+		EEPROM_WritePageDirect(Address, pData, len);
+		eeprom_busy = true;
+		#ifdef ENABLE_BUS_TRACE
+			TRACE_Log(TRACE_EEPROM_WRITE, Address, len);
+		#endif
+
+		EEPROM_WaitForWrite();
+
+		Address += len;
+		pData   += len;
+		Size    -= len;
+	}
+}
+
+bool EEPROM_GetDirectWrite(uint16_t Write, uint16_t *pAddress, uint16_t *pSize)
+{
+	if ((uint16_t)(g_eeprom_direct_writes - Write) > EEPROM_WRITE_LOG_SIZE)
+		return false;
+
+	*pAddress = eeprom_write_log[Write % EEPROM_WRITE_LOG_SIZE].addr;
+	*pSize    = eeprom_write_log[Write % EEPROM_WRITE_LOG_SIZE].size;
+	return true;
+}
+
+void EEPROM_WriteBuffer(uint16_t Address, const void *pBuffer)
+{
+	EEPROM_Write(Address, pBuffer, 8);
+}
+
+void EEPROM_QueueWrite(uint16_t Address, const void *pBuffer, unsigned int Size)
+{
+	const uint8_t *pData = (const uint8_t *)pBuffer;
+
+	if ((Address % 8) != 0 || (Size % 8) != 0)
+	{	// only whole blocks are queued
+		EEPROM_Write(Address, pBuffer, Size);
+		return;
+	}
+
+	for ( ; Size > 0; Address += 8, pData += 8, Size -= 8)
+	{
+		unsigned int i;
+
+		for (i = 0; i < eeprom_queue_count; i++)
+			if (eeprom_queue[i].addr == Address)
+				break;
+
+		if (i >= eeprom_queue_count)
+		{	// not already queued
+			if (eeprom_queue_count >= EEPROM_QUEUE_SIZE)
+			{	// full, make room the slow way
+				EEPROM_WaitForWrite();
+				EEPROM_StartNextPage();
+			}
+
+			i = eeprom_queue_count++;
+			eeprom_queue[i].addr = Address;
+		}
+
+		memcpy(eeprom_queue[i].data, pData, 8);
+	}
+}
+
+void EEPROM_Service(void)
+{
+	if (eeprom_busy)
+	{
+		if (EEPROM_IsBusyDirect())
+			return;
+		eeprom_busy = false;
+	}
+
+	if (eeprom_queue_count > 0)
+		EEPROM_StartNextPage();
+}
+
+bool EEPROM_IsPending(void)
+{
+	return (eeprom_busy || eeprom_queue_count > 0) ? true : false;
+}
+
+void EEPROM_Flush(void)
+{
+	while (eeprom_queue_count > 0)
+	{
+		EEPROM_WaitForWrite();
+		EEPROM_StartNextPage();
+	}
 
-	SYSTEM_DelayMs(10);
+	EEPROM_WaitForWrite();
 }
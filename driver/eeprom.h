@@ -17,10 +17,33 @@
 #ifndef DRIVER_EEPROM_H
 #define DRIVER_EEPROM_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#define EEPROM_PAGE_SIZE   32   // BL24C64
+#define EEPROM_QUEUE_SIZE  16   // 8 byte blocks waiting to be written
+
+extern uint16_t g_eeprom_direct_writes;   // EEPROM_Write() calls, lets anything caching the EEPROM spot outside writes
+
+// where direct write number Write (a g_eeprom_direct_writes count) went, so a cache
+// can drop just what was written over .. false once it's too old to be remembered
+bool EEPROM_GetDirectWrite(uint16_t Write, uint16_t *pAddress, uint16_t *pSize);
+
 void EEPROM_ReadBuffer(uint16_t Address, void *pBuffer, uint8_t Size);
-void EEPROM_WriteBuffer(uint16_t Address, const void *pBuffer);
+void EEPROM_Write(uint16_t Address, const void *pBuffer, unsigned int Size);
+void EEPROM_WriteBuffer(uint16_t Address, const void *pBuffer);   // 8 bytes
+
+// write-behind .. whole 8 byte blocks, rewrites of a still queued block replace it,
+// written out a page at a time from the main loop (EEPROM_Service)
+void EEPROM_QueueWrite(uint16_t Address, const void *pBuffer, unsigned int Size);
+void EEPROM_Service(void);
+bool EEPROM_IsPending(void);   // queued blocks or a page still programming
+void EEPROM_Flush(void);   // before a reboot or power down
+
+// the bus level, no queue
+void EEPROM_ReadBufferDirect(uint16_t Address, void *pBuffer, unsigned int Size);
+void EEPROM_WritePageDirect(uint16_t Address, const void *pBuffer, unsigned int Size);   // starts the page programming
+bool EEPROM_IsBusyDirect(void);
 
 #endif
 
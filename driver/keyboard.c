@@ -19,8 +19,11 @@
 #include "driver/gpio.h"
 #include "driver/keyboard.h"
 #include "driver/systick.h"
-#include "driver/i2c.h"
+#ifndef ENABLE_HOST_SIM
+	#include "driver/i2c.h"
+#endif
 #include "misc.h"
+#include "scheduler.h"
 
 uint8_t    g_ptt_debounce;
 uint8_t    g_key_debounce_press;
@@ -45,9 +48,9 @@ static const struct {
 	struct {
 		key_code_t key : 5;
 		uint8_t    pin : 3; // Pin 6 is highest
-	} pins[4];
+	} pins[KEYBOARD_ROW_KEYS];
 
-} keyboard[] = {
+} keyboard[KEYBOARD_ROWS] = {
 
 	{	// Zero row
 		// Set to zero to handle special case of nothing pulled down
@@ -99,65 +102,206 @@ static const struct {
 	}
 };
 
-key_code_t KEYBOARD_Poll(void)
+// the time-sliced scanner .. one row a tick, each row debounced on its own
+// (a row that's changing is read again on the following ticks till it settles)
+static unsigned int scan_row;
+static uint32_t     scan_time = UINT32_MAX;
+static uint8_t      row_state[KEYBOARD_ROWS];         // debounced, bit per slot
+static uint8_t      row_sample[KEYBOARD_ROWS];        // last read
+static uint8_t      row_count[KEYBOARD_ROWS];         // visits row_sample has read the same
+static uint32_t     row_sample_time[KEYBOARD_ROWS];   // when row_sample was first read
+
+static key_event_t  key_events[KEYBOARD_EVENT_QUEUE_SIZE];
+static unsigned int key_event_read;
+static unsigned int key_event_count;
+
+key_code_t KEYBOARD_RowKey(const unsigned int row, const unsigned int slot)
 {
-	key_code_t Key = KEY_INVALID;
+	return keyboard[row].pins[slot].key;
+}
 
-	// *****************
+#ifndef ENABLE_HOST_SIM
+// the host simulator has its own key feed for these (sim/keyboard.c)
 
-	for (unsigned int j = 0; j < ARRAY_SIZE(keyboard); j++)
-	{
-		uint16_t reg;
-		unsigned int i;
-		unsigned int k;
+uint8_t KEYBOARD_ReadRowDirect(const unsigned int row)
+{
+	uint16_t     reg;
+	uint8_t      keys = 0;
+	unsigned int i;
 
-		// Set all high
-		GPIOA->DATA |=  1u << GPIOA_PIN_KEYBOARD_4 |
-						1u << GPIOA_PIN_KEYBOARD_5 |
-						1u << GPIOA_PIN_KEYBOARD_6 |
-						1u << GPIOA_PIN_KEYBOARD_7;
+	// Set all high
+	GPIOA->DATA |=  1u << GPIOA_PIN_KEYBOARD_4 |
+					1u << GPIOA_PIN_KEYBOARD_5 |
+					1u << GPIOA_PIN_KEYBOARD_6 |
+					1u << GPIOA_PIN_KEYBOARD_7;
 
-		// Clear the pin we are selecting
-		GPIOA->DATA &= keyboard[j].set_to_zero_mask;
+	// Clear the pin we are selecting
+	GPIOA->DATA &= keyboard[row].set_to_zero_mask;
 
-		// Read all 4 GPIO pins at once .. with de-noise, max of 8 sample loops
-		for (i = 0, k = 0, reg = 0; i < 3 && k < 8; i++, k++)
-		{
-			uint16_t reg2;
+	SYSTICK_DelayUs(1);
+
+	// Read all 4 GPIO pins at once
+	reg = GPIOA->DATA;
 
-			SYSTICK_DelayUs(1);
+	for (i = 0; i < ARRAY_SIZE(keyboard[row].pins); i++)
+		if (!(reg & (1u << keyboard[row].pins[i].pin)) && keyboard[row].pins[i].key != KEY_INVALID)
+			keys |= 1u << i;
 
-			reg2 = GPIOA->DATA;
-			if (reg != reg2)
+	return keys;
+}
+
+void KEYBOARD_ReleaseDirect(void)
+{
+	// Create I2C stop condition since we might have toggled I2C pins
+	// This leaves GPIOA_PIN_KEYBOARD_4 and GPIOA_PIN_KEYBOARD_5 high
+	I2C_Stop();
+
+	// Reset VOICE pins
+	GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_KEYBOARD_6);
+	GPIO_SetBit(  &GPIOA->DATA, GPIOA_PIN_KEYBOARD_7);
+}
+
+#endif
+
+key_code_t KEYBOARD_Poll(void)
+{
+	key_code_t   Key = KEY_INVALID;
+	unsigned int j;
+
+	for (j = 0; j < ARRAY_SIZE(keyboard) && Key == KEY_INVALID; j++)
+	{
+		uint8_t      keys;
+		unsigned int i;
+		unsigned int k;
+
+		// read the row .. with de-noise, max of 8 sample loops
+		for (i = 0, k = 0, keys = 0; i < 3 && k < 8; i++, k++)
+		{
+			const uint8_t keys2 = KEYBOARD_ReadRowDirect(j);
+			if (keys != keys2)
 			{	// noise
-				reg = reg2;
-				i   = 0;
+				keys = keys2;
+				i    = 0;
 			}
 		}
 		if (i < 3)
 			break;	// noise is too bad
 
-		for (unsigned int i = 0; i < ARRAY_SIZE(keyboard[j].pins); i++)
+		for (i = 0; i < ARRAY_SIZE(keyboard[j].pins); i++)
 		{
-			const uint16_t mask = 1u << keyboard[j].pins[i].pin;
-			if (!(reg & mask))
+			if (keys & (1u << i))
 			{
 				Key = keyboard[j].pins[i].key;
 				break;
 			}
 		}
+	}
+
+	KEYBOARD_ReleaseDirect();
 
-		if (Key != KEY_INVALID)
-			break;
+	return Key;
+}
+
+static void KEYBOARD_PushEvent(const key_code_t key, const bool pressed, const uint32_t time_10ms)
+{
+	key_event_t *pEvent;
+
+	if (key_event_count >= ARRAY_SIZE(key_events))
+	{	// full, lose the oldest
+		key_event_read = (key_event_read + 1) % ARRAY_SIZE(key_events);
+		key_event_count--;
 	}
 
-	// Create I2C stop condition since we might have toggled I2C pins
-	// This leaves GPIOA_PIN_KEYBOARD_4 and GPIOA_PIN_KEYBOARD_5 high
-	I2C_Stop();
+	pEvent            = &key_events[(key_event_read + key_event_count++) % ARRAY_SIZE(key_events)];
+	pEvent->key       = key;
+	pEvent->pressed   = pressed;
+	pEvent->time_10ms = time_10ms;
+}
 
-	// Reset VOICE pins
-	GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_KEYBOARD_6);
-	GPIO_SetBit(  &GPIOA->DATA, GPIOA_PIN_KEYBOARD_7);
+// returns true once the row has settled
+static bool KEYBOARD_ScanRow(const unsigned int row, const uint32_t now)
+{
+	const uint8_t keys = KEYBOARD_ReadRowDirect(row);
+	uint8_t       changed;
+	unsigned int  i;
 
-	return Key;
+	if (keys != row_sample[row])
+	{	// changed (or noise), start counting again
+		row_sample[row]      = keys;
+		row_sample_time[row] = now;
+		row_count[row]       = 1;
+	}
+	else
+	if (row_count[row] < KEYBOARD_DEBOUNCE_SCANS)
+		row_count[row]++;
+
+	if (row_count[row] < KEYBOARD_DEBOUNCE_SCANS)
+		return false;
+
+	if (keys == row_state[row])
+		return true;
+
+	changed        = keys ^ row_state[row];
+	row_state[row] = keys;
+
+	for (i = 0; i < ARRAY_SIZE(keyboard[row].pins); i++)
+		if (changed & (1u << i))
+			KEYBOARD_PushEvent(keyboard[row].pins[i].key, (keys & (1u << i)) ? true : false, row_sample_time[row]);
+
+	return true;
+}
+
+void KEYBOARD_Scan(void)
+{
+	const uint32_t now  = g_global_sys_tick_counter;
+	unsigned int   rows = now - scan_time;
+
+	if (rows == 0)
+		return;   // done this tick's row already
+	scan_time = now;
+
+	// catch up on the ticks something else held the main loop up for
+	if (rows > ARRAY_SIZE(keyboard))
+		rows = ARRAY_SIZE(keyboard);
+
+	while (rows-- > 0)
+	{
+		if (!KEYBOARD_ScanRow(scan_row, now))
+			break;   // changing, look at it again next tick rather than in a full cycle's time
+		scan_row = (scan_row + 1) % ARRAY_SIZE(keyboard);
+	}
+
+	KEYBOARD_ReleaseDirect();
+}
+
+// the debounced key that's down, the first one in scan order if there are several
+key_code_t KEYBOARD_GetKey(void)
+{
+	unsigned int row;
+
+	for (row = 0; row < ARRAY_SIZE(keyboard); row++)
+	{
+		unsigned int i;
+
+		if (row_state[row] == 0)
+			continue;
+
+		for (i = 0; i < ARRAY_SIZE(keyboard[row].pins); i++)
+			if (row_state[row] & (1u << i))
+				return keyboard[row].pins[i].key;
+	}
+
+	return KEY_INVALID;
+}
+
+bool KEYBOARD_GetEvent(key_event_t *pEvent)
+{
+	if (key_event_count == 0)
+		return false;
+
+	*pEvent        = key_events[key_event_read];
+	key_event_read = (key_event_read + 1) % ARRAY_SIZE(key_events);
+	key_event_count--;
+
+	return true;
 }
@@ -45,6 +45,18 @@ enum key_code_e {
 };
 typedef enum key_code_e key_code_t;
 
+#define KEYBOARD_ROWS             5   // the side keys are the un-driven row
+#define KEYBOARD_ROW_KEYS         4
+#define KEYBOARD_DEBOUNCE_SCANS   2   // visits a row has to read the same for before it counts
+#define KEYBOARD_EVENT_QUEUE_SIZE 8
+
+// a debounced key change from the keypad scanner
+typedef struct {
+	key_code_t key;
+	bool       pressed;
+	uint32_t   time_10ms;   // tick the change was first seen
+} key_event_t;
+
 extern uint8_t    g_ptt_debounce;
 extern uint8_t    g_key_debounce_press;
 extern uint8_t    g_key_debounce_repeat;
@@ -57,7 +69,15 @@ extern bool       g_ptt_was_released;
 extern bool       g_ptt_was_pressed;
 extern uint8_t    g_keypad_locked;
 
-key_code_t KEYBOARD_Poll(void);
+key_code_t KEYBOARD_Poll(void);   // full blocking scan, for before the main loop's running
+
+void       KEYBOARD_Scan(void);   // scan the next row, once a tick however often it's called
+key_code_t KEYBOARD_GetKey(void);
+bool       KEYBOARD_GetEvent(key_event_t *pEvent);
+
+key_code_t KEYBOARD_RowKey(const unsigned int row, const unsigned int slot);
+uint8_t    KEYBOARD_ReadRowDirect(const unsigned int row);   // bit per row slot, 1 = down
+void       KEYBOARD_ReleaseDirect(void);
 
 #endif
 
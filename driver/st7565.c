@@ -17,22 +17,156 @@
 #include <stdint.h>
 #include <stdio.h>     // NULL
 
+#ifdef ENABLE_LCD_DMA
+	#include "bsp/dp32g030/dma.h"
+#endif
 #include "bsp/dp32g030/gpio.h"
 #include "bsp/dp32g030/spi.h"
 #include "driver/gpio.h"
 #include "driver/spi.h"
 #include "driver/st7565.h"
 #include "driver/system.h"
+#ifdef ENABLE_BUS_TRACE
+	#include "helper/trace.h"
+#endif
+#ifdef ENABLE_PROFILER
+	#include "helper/profiler.h"
+#endif
 #include "misc.h"
 
 uint8_t g_status_line[128];
 uint8_t g_frame_buffer[7][128];
 uint8_t contrast = 31;  // 0 ~ 63
 
+// what the display is currently showing, page 0 being the status line
+//
+// only the changed column span of each page gets sent, the display is
+// re-initialised and fully redrawn every ST7565_FULL_REFRESH_BLITS blits
+// to recover from the RF corrupting it
+static uint8_t      lcd_shadow[1 + ARRAY_SIZE(g_frame_buffer)][ARRAY_SIZE(g_frame_buffer[0])];
+static uint8_t      lcd_shadow_valid;     // bit per page
+static unsigned int lcd_blit_count;
+static bool         lcd_full_refresh;
+
+#ifdef ENABLE_LCD_DMA
+	// the changed page spans of a blit, streamed out of lcd_shadow[] by DMA CH1
+	// (CH0 is the UART RX) one page at a time, ST7565_Service() moves on to the
+	// next page when the previous one has gone out
+	typedef struct {
+		uint8_t line;
+		uint8_t first;
+		uint8_t count;
+	} lcd_dma_job_t;
+
+	// DMA handshake line for SPI0 TX .. going by the peripheral order (UART1 RX is MS1),
+	// not yet verified on hardware, so ENABLE_LCD_DMA is off by default
+	#define ST7565_DMA_MD_SEL  DMA_CH_MOD_MD_SEL_BITS_HSREQ_MS3
+
+	static lcd_dma_job_t lcd_dma_jobs[ARRAY_SIZE(lcd_shadow)];
+	static unsigned int  lcd_dma_job_count;
+	static unsigned int  lcd_dma_job_index;
+	static bool          lcd_dma_busy;
+	static bool          lcd_dma_failed;      // never saw a transfer complete, use the CPU
+
+	static void ST7565_StartDMAJob(void)
+	{
+		const lcd_dma_job_t *pJob = &lcd_dma_jobs[lcd_dma_job_index];
+
+		ST7565_SelectColumnAndLine(4 + pJob->first, pJob->line);
+		GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
+
+		DMA_INTST = DMA_INTST_CH1_TC_INTST_BITS_SET;
+
+		DMA_CH1->MSADDR = (uint32_t)(uintptr_t)&lcd_shadow[pJob->line][pJob->first];
+		DMA_CH1->MDADDR = (uint32_t)(uintptr_t)&SPI0->WDR;
+		DMA_CH1->MOD = 0
+			// Source
+			| DMA_CH_MOD_MS_ADDMOD_BITS_INCREMENT
+			| DMA_CH_MOD_MS_SIZE_BITS_8BIT
+			| DMA_CH_MOD_MS_SEL_BITS_SRAM
+			// Destination
+			| DMA_CH_MOD_MD_ADDMOD_BITS_NONE
+			| DMA_CH_MOD_MD_SIZE_BITS_8BIT
+			| ST7565_DMA_MD_SEL
+			;
+		DMA_CH1->CTR = 0
+			| DMA_CH_CTR_CH_EN_BITS_ENABLE
+			| (((pJob->count - 1u) << DMA_CH_CTR_LENGTH_SHIFT) & DMA_CH_CTR_LENGTH_MASK)
+			| DMA_CH_CTR_LOOP_BITS_DISABLE
+			| DMA_CH_CTR_PRI_BITS_LOW
+			;
+
+		SPI0->CR |= SPI_CR_TXDMAEN_MASK;
+	}
+
+	static void ST7565_StopDMA(void)
+	{
+		SPI0->CR &= ~SPI_CR_TXDMAEN_MASK;
+		DMA_CH1->CTR = DMA_CH_CTR_CH_EN_BITS_DISABLE;
+		DMA_INTST = DMA_INTST_CH1_TC_INTST_BITS_SET;
+
+		lcd_dma_job_count = 0;
+		lcd_dma_busy      = false;
+
+		SPI_ToggleMasterMode(&SPI0->CR, true);
+	}
+#endif
+
+void ST7565_Service(void)
+{
+	#ifdef ENABLE_LCD_DMA
+		if (!lcd_dma_busy || (DMA_INTST & DMA_INTST_CH1_TC_INTST_MASK) == 0)
+			return;
+
+		DMA_INTST = DMA_INTST_CH1_TC_INTST_BITS_SET;
+
+		SPI_WaitForUndocumentedTxFifoStatusBit();
+
+		SPI0->CR &= ~SPI_CR_TXDMAEN_MASK;
+
+		if (++lcd_dma_job_index < lcd_dma_job_count)
+			ST7565_StartDMAJob();
+		else
+			ST7565_StopDMA();
+	#endif
+}
+
+bool ST7565_IsBlitting(void)
+{
+	#ifdef ENABLE_LCD_DMA
+		return lcd_dma_busy;
+	#else
+		return false;
+	#endif
+}
+
+void ST7565_WaitForBlit(void)
+{
+	#ifdef ENABLE_LCD_DMA
+		unsigned int timeout = 0;
+
+		while (lcd_dma_busy)
+		{
+			ST7565_Service();
+
+			if (++timeout >= 200000)
+			{	// DMA isn't happening, send it all again with the CPU from now on
+				lcd_dma_failed   = true;
+				lcd_shadow_valid = 0;
+				ST7565_StopDMA();
+			}
+		}
+	#endif
+}
+
 void ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const unsigned int Size, const uint8_t *pBitmap)
 {
 	unsigned int i;
 
+	ST7565_WaitForBlit();
+
+	lcd_shadow_valid &= ~(1u << Line);
+
 	SPI_ToggleMasterMode(&SPI0->CR, false);
 
 	ST7565_SelectColumnAndLine(Column + 4U, Line);
@@ -61,30 +195,92 @@ void ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const u
 	SPI_ToggleMasterMode(&SPI0->CR, true);
 }
 
+static void ST7565_BlitLine(const unsigned int Line, const uint8_t *pData)
+{
+	uint8_t     *pShadow = lcd_shadow[Line];
+	unsigned int first   = 0;
+	unsigned int last    = ARRAY_SIZE(lcd_shadow[0]);
+	unsigned int i;
+
+	if (lcd_shadow_valid & (1u << Line))
+	{
+		while (first < last && pData[first] == pShadow[first])
+			first++;
+		if (first >= last)
+			return;   // no change
+		while (pData[last - 1] == pShadow[last - 1])
+			last--;
+	}
+
+	for (i = first; i < last; i++)
+		pShadow[i] = pData[i];
+
+	lcd_shadow_valid |= 1u << Line;
+
+	#ifdef ENABLE_LCD_DMA
+		if (!lcd_dma_failed)
+		{	// sent from the shadow once the whole blit is known
+			lcd_dma_job_t *pJob = &lcd_dma_jobs[lcd_dma_job_count++];
+			pJob->line  = Line;
+			pJob->first = first;
+			pJob->count = last - first;
+			return;
+		}
+	#endif
+
+	ST7565_SelectColumnAndLine(4 + first, Line);
+	GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
+	for (i = first; i < last; i++)
+	{
+		while ((SPI0->FIFOST & SPI_FIFOST_TFF_MASK) != SPI_FIFOST_TFF_BITS_NOT_FULL) {}
+		SPI0->WDR = pShadow[i];
+	}
+	SPI_WaitForUndocumentedTxFifoStatusBit();
+}
+
+static void ST7565_EndBlit(void)
+{
+	#ifdef ENABLE_LCD_DMA
+		if (lcd_dma_job_count > 0)
+		{	// the SPI stays selected till the last page has gone
+			lcd_dma_job_index = 0;
+			lcd_dma_busy      = true;
+			ST7565_StartDMAJob();
+			return;
+		}
+	#endif
+
+	SPI_ToggleMasterMode(&SPI0->CR, true);
+}
+
 void ST7565_BlitFullScreen(void)
 {
 	unsigned int Line;
 
-	// reset some of the displays settings to try and overcome the
-	// radios hardware problem - RF corrupting the display
-	ST7565_Init(false);
+	#ifdef ENABLE_PROFILER
+		const uint32_t start = PROFILER_Stamp();
+	#endif
+
+	ST7565_WaitForBlit();
+
+	if (lcd_full_refresh || ++lcd_blit_count >= ST7565_FULL_REFRESH_BLITS)
+	{
+		lcd_blit_count   = 0;
+		lcd_full_refresh = false;
+
+		// reset some of the displays settings to try and overcome the
+		// radios hardware problem - RF corrupting the display
+		ST7565_Init(false);
+
+		lcd_shadow_valid = 0;
+	}
 
 	SPI_ToggleMasterMode(&SPI0->CR, false);
 
 	ST7565_WriteByte(0x40);
 
 	for (Line = 0; Line < ARRAY_SIZE(g_frame_buffer); Line++)
-	{
-		unsigned int Column;
-		ST7565_SelectColumnAndLine(4, Line + 1);
-		GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
-		for (Column = 0; Column < ARRAY_SIZE(g_frame_buffer[0]); Column++)
-		{
-			while ((SPI0->FIFOST & SPI_FIFOST_TFF_MASK) != SPI_FIFOST_TFF_BITS_NOT_FULL) {}
-			SPI0->WDR = g_frame_buffer[Line][Column];
-		}
-		SPI_WaitForUndocumentedTxFifoStatusBit();
-	}
+		ST7565_BlitLine(Line + 1, g_frame_buffer[Line]);
 
 	#if 0
 		// whats the delay for, it holds things up :(
@@ -93,41 +289,47 @@ void ST7565_BlitFullScreen(void)
 //		SYSTEM_DelayMs(1);
 	#endif
 
-	SPI_ToggleMasterMode(&SPI0->CR, true);
+	ST7565_EndBlit();
+
+	#ifdef ENABLE_BUS_TRACE
+		TRACE_Log(TRACE_LCD_BLIT, 1, ARRAY_SIZE(g_frame_buffer));
+	#endif
+
+	#ifdef ENABLE_PROFILER
+		PROFILER_Record(PROFILE_BLIT_FULL_SCREEN, start);
+	#endif
 }
 
 void ST7565_BlitStatusLine(void)
 {	// the top small text line on the display
 
-	unsigned int i;
+	ST7565_WaitForBlit();
 
 	SPI_ToggleMasterMode(&SPI0->CR, false);
 
 	ST7565_WriteByte(0x40);    // start line ?
 
-	ST7565_SelectColumnAndLine(4, 0);
+	ST7565_BlitLine(0, g_status_line);
 
-	GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
-
-	for (i = 0; i < ARRAY_SIZE(g_status_line); i++)
-	{
-		while ((SPI0->FIFOST & SPI_FIFOST_TFF_MASK) != SPI_FIFOST_TFF_BITS_NOT_FULL) {}
-		SPI0->WDR = g_status_line[i];
-	}
+	ST7565_EndBlit();
 
-	SPI_WaitForUndocumentedTxFifoStatusBit();
-
-	SPI_ToggleMasterMode(&SPI0->CR, true);
+	#ifdef ENABLE_BUS_TRACE
+		TRACE_Log(TRACE_LCD_BLIT, 0, 1);
+	#endif
 }
 
 void ST7565_FillScreen(const uint8_t Value)
 {
 	unsigned int i;
 
+	ST7565_WaitForBlit();
+
 	// reset some of the displays settings to try and overcome the
 	// radios hardware problem - RF corrupting the display
 	ST7565_Init(false);
 
+	lcd_shadow_valid = 0;
+
 	SPI_ToggleMasterMode(&SPI0->CR, false);
 
 	for (i = 0; i < 8; i++)
@@ -148,10 +350,16 @@ void ST7565_FillScreen(const uint8_t Value)
 
 void ST7565_Init(const bool full)
 {
+	ST7565_WaitForBlit();
+
 	if (full)
 	{
 		SPI0_Init();
 
+		#ifdef ENABLE_LCD_DMA
+			DMA_CTR = (DMA_CTR & ~DMA_CTR_DMAEN_MASK) | DMA_CTR_DMAEN_BITS_ENABLE;
+		#endif
+
 		ST7565_HardwareReset();
 
 		SPI_ToggleMasterMode(&SPI0->CR, false);
@@ -207,6 +415,12 @@ void ST7565_Init(const bool full)
 
 void ST7565_HardwareReset(void)
 {
+	ST7565_WaitForBlit();
+
+	// the display needs setting up again and everything resending
+	lcd_shadow_valid = 0;
+	lcd_full_refresh = true;
+
 	GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_RES);
 	SYSTEM_DelayMs(1);
 	GPIO_ClearBit(&GPIOB->DATA, GPIOB_PIN_ST7565_RES);
@@ -236,7 +450,15 @@ void ST7565_WriteByte(const uint8_t Value)
 
 void ST7565_SetContrast(const uint8_t value)
 {
-	contrast = (value <= 63) ? value : 63;
+	const uint8_t new_contrast = (value <= 63) ? value : 63;
+
+	// the contrast only goes out with ST7565_Init(), have the next blit do that
+	// rather than wait for the periodic refresh .. the menu previews it as it's changed
+	if (contrast != new_contrast)
+	{
+		contrast         = new_contrast;
+		lcd_full_refresh = true;
+	}
 }
 
 uint8_t ST7565_GetContrast(void)
@@ -23,12 +23,18 @@
 #define LCD_WIDTH       128
 #define LCD_HEIGHT       64
 
+// full display re-init + redraw every this many full screen blits
+#define ST7565_FULL_REFRESH_BLITS   16
+
 extern uint8_t g_status_line[128];
 extern uint8_t g_frame_buffer[7][128];
 
 void    ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const unsigned int Size, const uint8_t *pBitmap);
 void    ST7565_BlitFullScreen(void);
 void    ST7565_BlitStatusLine(void);
+void    ST7565_Service(void);
+bool    ST7565_IsBlitting(void);
+void    ST7565_WaitForBlit(void);
 void    ST7565_FillScreen(const uint8_t Value);
 void    ST7565_Init(const bool full);
 void    ST7565_HardwareReset(void);
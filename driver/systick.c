@@ -17,16 +17,62 @@
 #include "ARMCM0.h"
 #include "driver/systick.h"
 #include "misc.h"
+#include "scheduler.h"
 
 // 0x20000324
 static uint32_t gTickMultiplier;
 
 void SYSTICK_Init(void)
 {
-	SysTick_Config(480000);
+	SysTick_Config(SYSTICK_CLOCKS_PER_TICK);
 	gTickMultiplier = 48;
 }
 
+// WFI till the next interrupt, returns the CPU clocks spent asleep
+//
+// call with interrupts disabled .. a pending interrupt still wakes the core,
+// it's then taken when they're enabled again, so nothing that arrives between
+// the caller deciding it's idle and the WFI gets missed
+uint32_t SYSTICK_Sleep(void)
+{
+	uint32_t start;
+	uint32_t end;
+
+	(void)SysTick->CTRL;     // clears COUNTFLAG
+	start = SysTick->VAL;
+
+	__WFI();
+
+	end = SysTick->VAL;
+
+	if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+		return start + (SysTick->LOAD + 1) - end;   // the tick that woke us
+
+	return start - end;
+}
+
+// free running CPU clock count, from the systick tick count and the
+// systick counter .. wraps every 89 seconds, fine for differences
+uint32_t SYSTICK_GetClocks(void)
+{
+	uint32_t ticks;
+	uint32_t pending;
+	uint32_t val;
+
+	// the counter may reload between the reads, go round till it didn't
+	do {
+		ticks   = g_global_sys_tick_counter;
+		pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+		val     = SysTick->VAL;
+	} while (ticks != g_global_sys_tick_counter || pending != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk));
+
+	// reloaded but not yet counted, we've interrupts disabled
+	if (pending)
+		ticks++;
+
+	return (ticks * SYSTICK_CLOCKS_PER_TICK) + (SYSTICK_CLOCKS_PER_TICK - 1 - val);
+}
+
 void SYSTICK_DelayUs(uint32_t Delay)
 {
 	const uint32_t ticks    = Delay * gTickMultiplier;
@@ -19,8 +19,12 @@
 
 #include <stdint.h>
 
-void SYSTICK_Init(void);
-void SYSTICK_DelayUs(uint32_t Delay);
+#define SYSTICK_CLOCKS_PER_TICK  480000u   // 10ms at 48MHz
+
+void     SYSTICK_Init(void);
+void     SYSTICK_DelayUs(uint32_t Delay);
+uint32_t SYSTICK_Sleep(void);
+uint32_t SYSTICK_GetClocks(void);
 
 #endif
 
@@ -17,7 +17,9 @@
 #include <string.h>
 #include <stdbool.h>
 
+#include "ARMCM0.h"
 #include "bsp/dp32g030/dma.h"
+#include "bsp/dp32g030/irq.h"
 #include "bsp/dp32g030/syscon.h"
 #include "bsp/dp32g030/uart.h"
 #include "driver/uart.h"
@@ -43,7 +45,7 @@ void UART_Init(void)
 	UART1->RXTO = 4;
 	UART1->FC = 0;
 	UART1->FIFO = UART_FIFO_RF_LEVEL_BITS_8_BYTE | UART_FIFO_RF_CLR_BITS_ENABLE | UART_FIFO_TF_CLR_BITS_ENABLE;
-	UART1->IE = 0;
+	UART1->IE = UART_IE_RXTO_BITS_ENABLE;   // only to wake the main loop, RX is by DMA
 
 	DMA_CTR = (DMA_CTR & ~DMA_CTR_DMAEN_MASK) | DMA_CTR_DMAEN_BITS_DISABLE;
 
@@ -81,6 +83,13 @@ void UART_Init(void)
 	DMA_CTR = (DMA_CTR & ~DMA_CTR_DMAEN_MASK) | DMA_CTR_DMAEN_BITS_ENABLE;
 
 	UART1->CTRL |= UART_CTRL_UARTEN_BITS_ENABLE;
+
+	NVIC_EnableIRQ((IRQn_Type)DP32_UART1_IRQn);
+}
+
+void HandlerUART1(void)
+{	// bytes have arrived, the DMA's already put them away
+	UART1->IF = UART_IF_RXTO_BITS_SET;
 }
 
 void UART_Send(const void *pBuffer, uint32_t Size)
@@ -23,6 +23,7 @@
 extern uint8_t UART_DMA_Buffer[256];
 
 void UART_Init(void);
+void HandlerUART1(void);
 void UART_Send(const void *pBuffer, uint32_t Size);
 void UART_SendText(const void *str);
 void UART_LogSend(const void *pBuffer, uint32_t Size);
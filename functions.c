@@ -35,6 +35,7 @@
 #include "helper/battery.h"
 #include "misc.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/status.h"
 #include "ui/ui.h"
@@ -69,15 +70,15 @@ void FUNCTION_Init(void)
 	g_squelch_lost     = false;
 
 	g_flag_tail_tone_elimination_complete   = false;
-	g_tail_tone_elimination_count_down_10ms = 0;
+	SCHEDULER_StopTimer(TIMER_TAIL_TONE);
 	g_found_CTCSS                           = false;
 	g_found_CDCSS                           = false;
-	g_found_CTCSS_count_down_10ms           = 0;
-	g_found_CDCSS_count_down_10ms           = 0;
+	SCHEDULER_StopTimer(TIMER_FOUND_CTCSS);
+	SCHEDULER_StopTimer(TIMER_FOUND_CDCSS);
 	g_end_of_rx_detected_maybe              = false;
 
 	#ifdef ENABLE_NOAA
-		g_noaa_count_down_10ms = 0;
+		SCHEDULER_StopTimer(TIMER_NOAA);
 	#endif
 
 	g_update_status = true;
@@ -157,7 +158,7 @@ void FUNCTION_Select(function_type_t Function)
 				UART_SendText("func power save\r\n");
 			#endif
 
-			g_power_save_10ms = g_eeprom.battery_save * 10;
+			SCHEDULER_StartTimer(TIMER_POWER_SAVE, g_eeprom.battery_save * 10);
 			g_power_save_expired = false;
 
 			g_rx_idle_mode = true;
@@ -271,7 +272,7 @@ void FUNCTION_Select(function_type_t Function)
 			break;
 	}
 
-	g_battery_save_count_down_10ms = battery_save_count_10ms;
+	SCHEDULER_StartTimer(TIMER_BATTERY_SAVE, battery_save_count_10ms);
 	g_schedule_power_save = false;
 
 	#if defined(ENABLE_FMRADIO)
@@ -0,0 +1,45 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#include "driver/systick.h"
+#include "helper/profiler.h"
+
+profiler_entry_t g_profiler[PROFILE_COUNT];
+
+uint32_t PROFILER_Stamp(void)
+{
+	return SYSTICK_GetClocks();
+}
+
+void PROFILER_Record(const profiler_id_t id, const uint32_t start)
+{
+	profiler_entry_t *pEntry = &g_profiler[id];
+	const uint32_t    clocks = PROFILER_Stamp() - start;
+
+	if (pEntry->count == 0 || pEntry->min > clocks)
+		pEntry->min = clocks;
+	if (pEntry->max < clocks)
+		pEntry->max = clocks;
+	pEntry->total += clocks;
+	pEntry->count++;
+}
+
+void PROFILER_Reset(void)
+{
+	memset(g_profiler, 0, sizeof(g_profiler));
+}
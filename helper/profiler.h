@@ -0,0 +1,48 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// the hot paths we time (CPU clocks, 48 per us)
+enum profiler_id_e {
+	PROFILE_TIME_SLICE_10MS = 0,   // APP_TimeSlice10ms
+	PROFILE_RADIO_INTERRUPTS,      // APP_CheckRadioInterrupts
+	PROFILE_DISPLAY_SCREEN,        // GUI_DisplayScreen
+	PROFILE_BLIT_FULL_SCREEN,      // ST7565_BlitFullScreen
+	PROFILE_SETUP_REGISTERS,       // RADIO_SetupRegisters
+	PROFILE_AM_FIX,                // AM_fix_10ms
+	PROFILE_UART_COMMAND,          // UART_HandleCommand
+	PROFILE_COUNT
+};
+typedef enum profiler_id_e profiler_id_t;
+
+typedef struct {
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+	uint32_t count;
+} profiler_entry_t;
+
+extern profiler_entry_t g_profiler[PROFILE_COUNT];
+
+uint32_t PROFILER_Stamp(void);
+void     PROFILER_Record(const profiler_id_t id, const uint32_t start);
+void     PROFILER_Reset(void);
+
+#endif
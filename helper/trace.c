@@ -0,0 +1,44 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#include "driver/systick.h"
+#include "helper/trace.h"
+
+trace_entry_t g_trace[TRACE_SIZE];
+uint32_t      g_trace_count;
+bool          g_trace_paused;
+
+void TRACE_Log(const trace_type_t type, const uint16_t addr, const uint16_t value)
+{
+	trace_entry_t *pEntry;
+
+	if (g_trace_paused)
+		return;
+
+	pEntry        = &g_trace[g_trace_count++ % TRACE_SIZE];
+	pEntry->time  = SYSTICK_GetClocks();
+	pEntry->addr  = addr;
+	pEntry->value = value;
+	pEntry->type  = type;
+}
+
+void TRACE_Clear(void)
+{
+	memset(g_trace, 0, sizeof(g_trace));
+	g_trace_count = 0;
+}
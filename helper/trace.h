@@ -0,0 +1,53 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef TRACE_SIZE
+	#define TRACE_SIZE  64   // entries, a power of 2
+#endif
+
+enum trace_type_e {
+	TRACE_BK4819_READ = 0,       // went out on the bus
+	TRACE_BK4819_READ_SHADOW,    // came from the register shadow
+	TRACE_BK4819_WRITE,          // went out on the bus
+	TRACE_BK4819_WRITE_SKIPPED,  // dropped, the register already held the value
+	TRACE_EEPROM_READ,           // addr = EEPROM address, value = bytes
+	TRACE_EEPROM_WRITE,          // addr = EEPROM address, value = bytes
+	TRACE_LCD_BLIT               // addr = first display line (0 = status line), value = lines
+};
+typedef enum trace_type_e trace_type_t;
+
+typedef struct {
+	uint32_t time;    // CPU clocks (SYSTICK_GetClocks)
+	uint16_t addr;    // register or address
+	uint16_t value;
+	uint8_t  type;    // trace_type_t
+	uint8_t  pad[3];
+} trace_entry_t;
+
+extern trace_entry_t g_trace[TRACE_SIZE];
+extern uint32_t      g_trace_count;    // entries logged since the last clear, the newest is at (g_trace_count - 1) % TRACE_SIZE
+extern bool          g_trace_paused;
+
+void TRACE_Log(const trace_type_t type, const uint16_t addr, const uint16_t value);
+void TRACE_Clear(void);
+
+#endif
@@ -18,6 +18,8 @@
 
 #include <stdint.h>
 
+#include "init.h"
+
 extern uint32_t __bss_start__[];
 extern uint32_t __bss_end__[];
 extern uint8_t flash_data_start[];
@@ -44,3 +46,21 @@ void DATA_Init(void)
 	for (i = 0; i < (Size / 4); i++)
 		*pDataRam++ = *pDataFlash++;
 }
+
+// HandlerReset paints everything from the end of .bss up to the initial
+// stack pointer with STACK_PAINT, the first word (from the bottom) that's
+// been changed is the deepest the stack has gone since reset
+uint32_t STACK_GetHighWater(void)
+{
+	const uint32_t *pWord = __bss_end__;
+
+	while (pWord < (const uint32_t *)STACK_TOP && *pWord == STACK_PAINT)
+		pWord++;
+
+	return STACK_TOP - (uint32_t)pWord;
+}
+
+uint32_t STACK_GetSize(void)
+{
+	return STACK_TOP - (uint32_t)__bss_end__;
+}
@@ -0,0 +1,28 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef INIT_H
+#define INIT_H
+
+#include <stdint.h>
+
+#define STACK_TOP    0x20003FF0u   // initial stack pointer, as set by HandlerReset
+#define STACK_PAINT  0xDEADBEEFu   // must match HandlerReset
+
+uint32_t STACK_GetHighWater(void);   // bytes of stack used at its deepest since reset
+uint32_t STACK_GetSize(void);        // bytes between the end of .bss and STACK_TOP
+
+#endif
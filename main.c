@@ -17,6 +17,8 @@
 #include <string.h>
 #include <stdio.h>     // NULL
 
+#include "ARMCM0.h"
+
 #ifdef ENABLE_AM_FIX
 	#include "am_fix.h"
 #endif
@@ -28,26 +30,53 @@
 #include "board.h"
 #include "driver/backlight.h"
 #include "driver/bk4819.h"
+#include "driver/eeprom.h"
 #include "driver/gpio.h"
 #include "driver/st7565.h"
 #include "driver/system.h"
 #include "driver/systick.h"
 #include "driver/uart.h"
+#ifdef ENABLE_UART
+	#include "app/uart.h"
+#endif
 #include "helper/battery.h"
 #include "helper/boot.h"
+#ifdef ENABLE_PROFILER
+	#include "helper/profiler.h"
+#endif
 #include "misc.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/lock.h"
 #include "ui/welcome.h"
 #include "ui/menu.h"
 #include "version.h"
 
+static uint32_t idle_clocks;   // spent in WFI since the last 500ms slice
+
 void _putchar(char c)
 {
 	UART_Send((uint8_t *)&c, 1);
 }
 
+// nothing for the main loop to do till the next interrupt
+static bool MAIN_IsIdle(void)
+{
+	if (g_next_time_slice || g_next_time_slice_500ms)
+		return false;
+
+	if (ST7565_IsBlitting() || EEPROM_IsPending())
+		return false;
+
+	#ifdef ENABLE_UART
+		if (UART_IsDataPending())
+			return false;
+	#endif
+
+	return true;
+}
+
 void Main(void)
 {
 	unsigned int i;
@@ -68,7 +97,7 @@ void Main(void)
 	BOARD_Init();
 	UART_Init();
 
-	g_boot_counter_10ms = 250;   // 2.5 sec
+	SCHEDULER_StartTimer(TIMER_BOOT, 250);   // 2.5 sec
 
 	#if defined(ENABLE_UART)
 		UART_SendText(UART_Version_str);
@@ -167,7 +196,7 @@ void Main(void)
 			{
 				if (KEYBOARD_Poll() != KEY_INVALID)
 				{	// halt boot beeps and cancel boot screen
-					g_boot_counter_10ms = 0;
+					SCHEDULER_StopTimer(TIMER_BOOT);
 					break;
 				}
 				#ifdef ENABLE_BOOT_BEEPS
@@ -218,18 +247,47 @@ void Main(void)
 
 	while (1)
 	{
+		bool busy = false;
+
+		#ifdef ENABLE_LCD_DMA
+			ST7565_Service();
+		#endif
+
+		EEPROM_Service();   // queued settings/channel writes
+
 		APP_Update();
 
 		if (g_next_time_slice)
 		{
-			APP_TimeSlice10ms();
+			#ifdef ENABLE_PROFILER
+				const uint32_t start = PROFILER_Stamp();
+				APP_TimeSlice10ms();
+				PROFILER_Record(PROFILE_TIME_SLICE_10MS, start);
+			#else
+				APP_TimeSlice10ms();
+			#endif
 			g_next_time_slice = false;
+			busy = true;
 		}
 
 		if (g_next_time_slice_500ms)
 		{
+			g_cpu_idle_percent = (idle_clocks < (50 * SYSTICK_CLOCKS_PER_TICK)) ? (idle_clocks * 100u) / (50 * SYSTICK_CLOCKS_PER_TICK) : 100;
+			idle_clocks = 0;
+
 			APP_TimeSlice500ms();
 			g_next_time_slice_500ms = false;
+			busy = true;
+		}
+
+		// a slice can leave work for APP_Update(), so go round once more after one
+		if (!busy)
+		{	// sleep till the systick or a UART RX timeout .. every tick wakes us, the 10ms
+			// slice polls the BK4819 (its IRQ line isn't wired to us) and scans a key row
+			__disable_irq();
+			if (MAIN_IsIdle())
+				idle_clocks += SYSTICK_Sleep();
+			__enable_irq();
 		}
 	}
 }
@@ -143,7 +143,7 @@ volatile uint16_t     g_dual_watch_count_down_10ms;
 volatile bool         g_dual_watch_count_down_expired = true;
 bool                  g_dual_watch_active;
 
-volatile uint8_t      g_serial_config_count_down_500ms;
+volatile uint16_t     g_serial_config_count_down_500ms;
 
 volatile bool         g_next_time_slice_500ms;
 
@@ -240,12 +240,14 @@ bool                  g_unhide_hidden = false;
 uint8_t               g_show_chan_prefix;
 
 volatile bool         g_next_time_slice;
-volatile uint8_t      g_found_CDCSS_count_down_10ms;
-volatile uint8_t      g_found_CTCSS_count_down_10ms;
+volatile uint16_t     g_found_CDCSS_count_down_10ms;
+volatile uint16_t     g_found_CTCSS_count_down_10ms;
 #ifdef ENABLE_VOX
 	volatile uint16_t g_vox_stop_count_down_10ms;
 #endif
 volatile bool         g_next_time_slice_40ms;
+uint8_t               g_cpu_idle_percent;
+uint8_t               g_key_latency_10ms;
 #ifdef ENABLE_NOAA
 	volatile uint16_t g_noaa_count_down_10ms = 0;
 	volatile bool     g_schedule_noaa       = true;
@@ -255,7 +257,7 @@ volatile bool         g_flag_tail_tone_elimination_complete;
 	volatile bool     g_schedule_fm;
 #endif
 
-volatile uint8_t      g_boot_counter_10ms;
+volatile uint16_t     g_boot_counter_10ms;
 
 int16_t               g_current_rssi[2] = {0, 0};  // now one per VFO
 
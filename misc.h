@@ -220,7 +220,7 @@ extern volatile uint16_t     g_dual_watch_count_down_10ms;
 extern volatile bool         g_dual_watch_count_down_expired;
 extern bool                  g_dual_watch_active;
 
-extern volatile uint8_t      g_serial_config_count_down_500ms;
+extern volatile uint16_t     g_serial_config_count_down_500ms;
 
 extern volatile bool         g_next_time_slice_500ms;
 
@@ -313,12 +313,14 @@ extern bool                  g_unhide_hidden;
 	extern uint8_t           g_fm_channel_position;
 #endif
 extern uint8_t               g_show_chan_prefix;
-extern volatile uint8_t      g_found_CDCSS_count_down_10ms;
-extern volatile uint8_t      g_found_CTCSS_count_down_10ms;
+extern volatile uint16_t     g_found_CDCSS_count_down_10ms;
+extern volatile uint16_t     g_found_CTCSS_count_down_10ms;
 #ifdef ENABLE_VOX
 	extern volatile uint16_t g_vox_stop_count_down_10ms;
 #endif
 extern volatile bool         g_next_time_slice_40ms;
+extern uint8_t               g_cpu_idle_percent;
+extern uint8_t               g_key_latency_10ms;     // last key press, from first seen to handled
 #ifdef ENABLE_NOAA
 	extern volatile uint16_t g_noaa_count_down_10ms;
 	extern volatile bool     g_schedule_noaa;
@@ -328,7 +330,7 @@ extern volatile bool         g_flag_tail_tone_elimination_complete;
 	extern volatile bool     g_schedule_fm;
 #endif
 extern int16_t               g_current_rssi[2];   // now one per VFO
-extern volatile uint8_t      g_boot_counter_10ms;
+extern volatile uint16_t     g_boot_counter_10ms;
 
 unsigned int get_TX_VFO(void);
 unsigned int get_RX_VFO(void);
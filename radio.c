@@ -30,8 +30,12 @@
 #include "frequencies.h"
 #include "functions.h"
 #include "helper/battery.h"
+#ifdef ENABLE_PROFILER
+	#include "helper/profiler.h"
+#endif
 #include "misc.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/menu.h"
 
@@ -44,6 +48,24 @@ uint8_t         g_selected_code;
 step_setting_t  g_step_setting;
 vfo_state_t     g_vfo_state[2];
 
+// the memory channels in either scan list, unpacked from the EEPROM so a scan hop doesn't
+// have to touch the I2C bus .. any others, or past the first CHANNEL_INDEX_SIZE, are read as they're used
+#define CHANNEL_INDEX_SIZE  64
+
+static channel_index_t channel_index[CHANNEL_INDEX_SIZE];
+static uint8_t         channel_index_channel[CHANNEL_INDEX_SIZE];   // ascending
+static uint8_t         channel_index_count;
+static uint16_t        channel_index_writes;   // the g_eeprom_direct_writes the caches have caught up with
+
+// scan list 1, scan list 2 and all valid channels, a bit per memory channel
+static uint32_t        scan_list_bits[3][(USER_CHANNEL_LAST + 32) / 32];
+
+// likewise the squelch thresholds for the current squelch level, and the TX power calibration
+static uint8_t         squelch_cache[2][6];
+static uint8_t         squelch_cache_level;    // 0 = not loaded
+static uint8_t         txp_cache[7][9];        // per band, low/mid/high power x 3 points
+static uint8_t         txp_cache_valid;        // bit per band
+
 bool RADIO_CheckValidChannel(uint16_t Channel, bool bCheckScanList, uint8_t VFO)
 {	// return true if the channel appears valid
 
@@ -93,27 +115,143 @@ bool RADIO_CheckValidChannel(uint16_t Channel, bool bCheckScanList, uint8_t VFO)
 	return true;
 }
 
-uint8_t RADIO_FindNextChannel(uint8_t Channel, scan_state_dir_t Direction, bool bCheckScanList, uint8_t VFO)
+// next channel set in the bitmap, starting at Channel itself and wrapping round .. -1 if there's none
+static int RADIO_FindChannelBit(const uint32_t *pBits, unsigned int Channel, const int Direction)
 {
 	unsigned int i;
 
-	for (i = 0; i <= USER_CHANNEL_LAST; i++)
+	for (i = 0; i < (ARRAY_SIZE(scan_list_bits[0]) * 32); )
 	{
-		if (Channel == 0xFF)
-			Channel = USER_CHANNEL_LAST;
-		else
-		if (Channel > USER_CHANNEL_LAST)
-			Channel = USER_CHANNEL_FIRST;
+		const uint32_t     word = pBits[Channel / 32];
+		const unsigned int step = (word != 0) ? 1 : (Direction > 0) ? 32 - (Channel % 32) : (Channel % 32) + 1;   // skip empty words whole
 
-		if (RADIO_CheckValidChannel(Channel, bCheckScanList, VFO))
+		if (word & (1u << (Channel % 32)))
 			return Channel;
 
-		Channel += Direction;
+		i += step;
+
+		if (Direction > 0)
+			Channel = ((Channel + step) > USER_CHANNEL_LAST) ? USER_CHANNEL_FIRST : Channel + step;
+		else
+			Channel = (Channel < (USER_CHANNEL_FIRST + step)) ? USER_CHANNEL_LAST : Channel - step;
+	}
+
+	return -1;
+}
+
+uint8_t RADIO_FindNextChannel(uint8_t Channel, scan_state_dir_t Direction, bool bCheckScanList, uint8_t VFO)
+{
+	const unsigned int list = (bCheckScanList && VFO < 2) ? VFO : 2;
+	unsigned int       i;
+
+	if (Channel == 0xFF)
+		Channel = USER_CHANNEL_LAST;
+	else
+	if (Channel > USER_CHANNEL_LAST)
+		Channel = USER_CHANNEL_FIRST;
+
+	// the scan list's priority channels are left out (they're scanned separately),
+	// so there's at most those two to step over before going all the way round
+	for (i = 0; i < 4; i++)
+	{
+		const int next = RADIO_FindChannelBit(scan_list_bits[list], Channel, Direction);
+		if (next < 0)
+			break;
+
+		if (list < 2 && (next == g_eeprom.scan_list_priority_ch1[list] || next == g_eeprom.scan_list_priority_ch2[list]))
+		{
+			Channel = next + Direction;
+			if (Channel == 0xFF)
+				Channel = USER_CHANNEL_LAST;
+			else
+			if (Channel > USER_CHANNEL_LAST)
+				Channel = USER_CHANNEL_FIRST;
+			continue;
+		}
+
+		return next;
 	}
 
 	return 0xFF;
 }
 
+// the index slot holding Channel, or if there's none -(the slot it'd go in + 1)
+static int RADIO_FindChannelIndex(const unsigned int Channel)
+{
+	unsigned int lo = 0;
+	unsigned int hi = channel_index_count;
+
+	while (lo < hi)
+	{
+		const unsigned int mid = (lo + hi) / 2;
+		if (channel_index_channel[mid] == Channel)
+			return mid;
+		if (channel_index_channel[mid] < Channel)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return -(int)lo - 1;
+}
+
+static void RADIO_UpdateChannelIndexMember(const unsigned int Channel, const bool member)
+{
+	const int slot = RADIO_FindChannelIndex(Channel);
+
+	if (slot >= 0 && !member)
+	{
+		channel_index_count--;
+		memmove(&channel_index[slot],         &channel_index[slot + 1],         (channel_index_count - slot) * sizeof(channel_index[0]));
+		memmove(&channel_index_channel[slot], &channel_index_channel[slot + 1], (channel_index_count - slot) * sizeof(channel_index_channel[0]));
+	}
+	else
+	if (slot < 0 && member && channel_index_count < CHANNEL_INDEX_SIZE)
+	{	// it's read in on its first use
+		const unsigned int at = -slot - 1;
+		memmove(&channel_index[at + 1],         &channel_index[at],         (channel_index_count - at) * sizeof(channel_index[0]));
+		memmove(&channel_index_channel[at + 1], &channel_index_channel[at], (channel_index_count - at) * sizeof(channel_index_channel[0]));
+		channel_index_channel[at] = Channel;
+		channel_index[at].valid   = 0;
+		channel_index_count++;
+	}
+}
+
+void RADIO_UpdateScanLists(const unsigned int Channel)
+{
+	const uint8_t  Attributes = g_user_channel_attributes[Channel];
+	const uint32_t bit        = 1u << (Channel % 32);
+	unsigned int   i;
+
+	if (Channel > USER_CHANNEL_LAST)
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(scan_list_bits); i++)
+		scan_list_bits[i][Channel / 32] &= ~bit;
+
+	if ((Attributes & USER_CH_BAND_MASK) > BAND7_470MHz)
+	{	// unused channel
+		RADIO_UpdateChannelIndexMember(Channel, false);
+		return;
+	}
+
+	if (Attributes & USER_CH_SCANLIST1)
+		scan_list_bits[0][Channel / 32] |= bit;
+	if (Attributes & USER_CH_SCANLIST2)
+		scan_list_bits[1][Channel / 32] |= bit;
+	scan_list_bits[2][Channel / 32] |= bit;
+
+	RADIO_UpdateChannelIndexMember(Channel, (Attributes & (USER_CH_SCANLIST1 | USER_CH_SCANLIST2)) != 0);
+}
+
+void RADIO_BuildScanLists(void)
+{
+	unsigned int Channel;
+
+	for (Channel = 0; Channel <= USER_CHANNEL_LAST; Channel++)
+		RADIO_UpdateScanLists(Channel);
+}
+
 void RADIO_InitInfo(vfo_info_t *pInfo, const uint8_t ChannelSave, const uint32_t Frequency)
 {
 	memset(pInfo, 0, sizeof(*pInfo));
@@ -138,6 +276,246 @@ void RADIO_InitInfo(vfo_info_t *pInfo, const uint8_t ChannelSave, const uint32_t
 	RADIO_ConfigureSquelchAndOutputPower(pInfo);
 }
 
+// unpack and sanity check a channel's 16 byte EEPROM record
+static void RADIO_PackChannel(channel_index_t *pEntry, const uint8_t *pData)
+{
+	uint32_t frequency;
+	uint32_t offset;
+	uint8_t  Tmp;
+
+	memset(pEntry, 0, sizeof(*pEntry));
+
+	// ***************
+
+	Tmp = pData[8 + 3] & 0x0F;
+	if (Tmp > TX_OFFSET_FREQ_DIR_SUB)
+		Tmp = 0;
+	pEntry->tx_offset_freq_dir = Tmp;
+	pEntry->am_mode            = (pData[8 + 3] >> 4) & 1u;
+
+	Tmp = pData[8 + 6];
+	if (Tmp >= ARRAY_SIZE(STEP_FREQ_TABLE))
+		Tmp = STEP_12_5kHz;
+	pEntry->step_setting = Tmp;
+
+	Tmp = pData[8 + 7];
+	if (Tmp > (ARRAY_SIZE(g_sub_menu_SCRAMBLER) - 1))
+		Tmp = 0;
+	pEntry->scrambling_type = Tmp;
+
+	pEntry->rx_code_type = (pData[8 + 2] >> 0) & 0x0F;
+	pEntry->tx_code_type = (pData[8 + 2] >> 4) & 0x0F;
+
+	Tmp = pData[8 + 0];
+	switch ((pData[8 + 2] >> 0) & 0x0F)
+	{
+		default:
+		case CODE_TYPE_OFF:
+			pEntry->rx_code_type = CODE_TYPE_OFF;
+			Tmp = 0;
+			break;
+
+		case CODE_TYPE_CONTINUOUS_TONE:
+			if (Tmp > (ARRAY_SIZE(CTCSS_OPTIONS) - 1))
+				Tmp = 0;
+			break;
+
+		case CODE_TYPE_DIGITAL:
+		case CODE_TYPE_REVERSE_DIGITAL:
+			if (Tmp > (ARRAY_SIZE(DCS_OPTIONS) - 1))
+				Tmp = 0;
+			break;
+	}
+	pEntry->rx_code = Tmp;
+
+	Tmp = pData[8 + 1];
+	switch ((pData[8 + 2] >> 4) & 0x0F)
+	{
+		default:
+		case CODE_TYPE_OFF:
+			pEntry->tx_code_type = CODE_TYPE_OFF;
+			Tmp = 0;
+			break;
+
+		case CODE_TYPE_CONTINUOUS_TONE:
+			if (Tmp > (ARRAY_SIZE(CTCSS_OPTIONS) - 1))
+				Tmp = 0;
+			break;
+
+		case CODE_TYPE_DIGITAL:
+		case CODE_TYPE_REVERSE_DIGITAL:
+			if (Tmp > (ARRAY_SIZE(DCS_OPTIONS) - 1))
+				Tmp = 0;
+			break;
+	}
+	pEntry->tx_code = Tmp;
+
+	if (pData[8 + 4] == 0xFF)
+	{
+		pEntry->frequency_reverse = false;
+		pEntry->channel_bandwidth = BK4819_FILTER_BW_WIDE;
+		pEntry->output_power      = OUTPUT_POWER_LOW;
+		pEntry->busy_channel_lock = false;
+	}
+	else
+	{
+		const uint8_t d4 = pData[8 + 4];
+		pEntry->frequency_reverse = ((d4 >> 0) & 1u) ? true : false;
+		pEntry->channel_bandwidth = ((d4 >> 1) & 1u) ? true : false;
+		pEntry->output_power      =  (d4 >> 2) & 3u;
+		pEntry->busy_channel_lock = ((d4 >> 4) & 1u) ? true : false;
+	}
+
+	if (pData[8 + 5] == 0xFF)
+	{
+		pEntry->dtmf_decoding_enable = false;
+		pEntry->dtmf_ptt_id_tx_mode  = PTT_ID_OFF;
+	}
+	else
+	{
+		pEntry->dtmf_decoding_enable = ((pData[8 + 5] >> 0) & 1u) ? true : false;
+		pEntry->dtmf_ptt_id_tx_mode  = ((pData[8 + 5] >> 1) & 7u);
+	}
+
+	// ***************
+
+	memmove(&frequency, pData + 0, sizeof(frequency));
+	memmove(&offset,    pData + 4, sizeof(offset));
+
+	// anything past the top band ends up clamped to its upper edge anyway
+	if (frequency > CHANNEL_INDEX_FREQ_MAX)
+		frequency = CHANNEL_INDEX_FREQ_MAX;
+	pEntry->frequency = frequency;
+
+	if (offset >= 100000000)
+		offset = 1000000;
+	pEntry->tx_offset_freq = offset;
+}
+
+// drops whatever's cached from the EEPROM between Start and End
+static void RADIO_DropCached(const uint32_t Start, const uint32_t End)
+{
+	unsigned int i;
+
+	for (i = 0; i < channel_index_count; i++)
+	{
+		const uint32_t Base = channel_index_channel[i] * 16;
+		if (Base < End && (Base + 16) > Start)
+			channel_index[i].valid = 0;
+	}
+
+	if (Start < 0x1EC0 && End > 0x1E00)   // squelch thresholds
+		squelch_cache_level = 0;
+
+	if (Start < 0x1F40 && End > 0x1ED0)   // TX power calibration
+		txp_cache_valid = 0;
+}
+
+static void RADIO_CheckChannelIndex(void)
+{	// catch up with whatever (UART, air-copy, reset, the spectrum's blacklist) wrote the EEPROM behind our back
+	while (channel_index_writes != g_eeprom_direct_writes)
+	{
+		uint16_t Address;
+		uint16_t Size;
+
+		if (!EEPROM_GetDirectWrite(channel_index_writes, &Address, &Size))
+		{	// too many to go through
+			channel_index_writes = g_eeprom_direct_writes;
+			RADIO_DropCached(0, 0x10000);
+			return;
+		}
+
+		channel_index_writes++;
+		RADIO_DropCached(Address, (uint32_t)Address + Size);
+	}
+}
+
+// the 6 squelch thresholds for the current squelch level .. set 0 = VHF, 1 = UHF
+static const uint8_t *RADIO_GetSquelchThresholds(const unsigned int set)
+{
+	RADIO_CheckChannelIndex();
+
+	if (squelch_cache_level != g_eeprom.squelch_level)
+	{
+		unsigned int i;
+
+		for (i = 0; i < 6; i++)
+		{
+			EEPROM_ReadBuffer(0x1E60 + g_eeprom.squelch_level + (i * 0x10), &squelch_cache[0][i], 1);
+			EEPROM_ReadBuffer(0x1E00 + g_eeprom.squelch_level + (i * 0x10), &squelch_cache[1][i], 1);
+		}
+
+		squelch_cache_level = g_eeprom.squelch_level;
+	}
+
+	return squelch_cache[set];
+}
+
+// reads in the members RADIO_BuildScanLists() picked
+void RADIO_BuildChannelIndex(void)
+{
+	unsigned int i = 0;
+
+	channel_index_writes = g_eeprom_direct_writes;
+
+	// the members among each 8 channels (128 bytes) in the one EEPROM read
+	while (i < channel_index_count)
+	{
+		const unsigned int Group = channel_index_channel[i] & ~7u;
+		uint8_t            Data[8][16];
+
+		EEPROM_ReadBuffer(Group * 16, Data, sizeof(Data));
+
+		for ( ; i < channel_index_count && (channel_index_channel[i] & ~7u) == Group; i++)
+		{
+			RADIO_PackChannel(&channel_index[i], Data[channel_index_channel[i] - Group]);
+			channel_index[i].valid = 1;
+		}
+	}
+}
+
+void RADIO_InvalidateChannelIndex(const unsigned int Channel)
+{
+	const int slot = RADIO_FindChannelIndex(Channel);
+	if (slot >= 0)
+		channel_index[slot].valid = 0;
+}
+
+// from the index if it's in it, else read into *pEntry
+static const channel_index_t *RADIO_GetChannelIndex(const unsigned int Channel, channel_index_t *pEntry)
+{
+	const int slot = RADIO_FindChannelIndex(Channel);
+
+	RADIO_CheckChannelIndex();
+
+	if (slot >= 0)
+	{
+		pEntry = &channel_index[slot];
+		if (pEntry->valid)
+			return pEntry;
+	}
+
+	{	// not indexed, or edited since
+		uint8_t Data[16];
+		EEPROM_ReadBuffer(Channel * 16, Data, sizeof(Data));
+		RADIO_PackChannel(pEntry, Data);
+		pEntry->valid = 1;
+	}
+
+	return pEntry;
+}
+
+bool RADIO_GetIndexedFrequency(const unsigned int Channel, uint32_t *pFrequency)
+{
+	channel_index_t entry;
+
+	if (RADIO_FindChannelIndex(Channel) < 0)
+		return false;
+
+	*pFrequency = RADIO_GetChannelIndex(Channel, &entry)->frequency;
+	return true;
+}
+
 void RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure)
 {
 	uint8_t     Channel;
@@ -242,121 +620,39 @@ void RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure
 
 	if (configure == VFO_CONFIGURE_RELOAD || Channel >= FREQ_CHANNEL_FIRST)
 	{
-		uint8_t Tmp;
-		uint8_t Data[8];
-
-		// ***************
-
-		EEPROM_ReadBuffer(Base + 8, Data, sizeof(Data));
-
-		Tmp = Data[3] & 0x0F;
-		if (Tmp > TX_OFFSET_FREQ_DIR_SUB)
-			Tmp = 0;
-		g_eeprom.vfo_info[VFO].tx_offset_freq_dir = Tmp;
-		g_eeprom.vfo_info[VFO].am_mode            = (Data[3] >> 4) & 1u;
-
-		Tmp = Data[6];
-		if (Tmp >= ARRAY_SIZE(STEP_FREQ_TABLE))
-			Tmp = STEP_12_5kHz;
-		g_eeprom.vfo_info[VFO].step_setting  = Tmp;
-		g_eeprom.vfo_info[VFO].step_freq     = STEP_FREQ_TABLE[Tmp];
-
-		Tmp = Data[7];
-		if (Tmp > (ARRAY_SIZE(g_sub_menu_SCRAMBLER) - 1))
-			Tmp = 0;
-		g_eeprom.vfo_info[VFO].scrambling_type = Tmp;
-
-		g_eeprom.vfo_info[VFO].freq_config_rx.code_type = (Data[2] >> 0) & 0x0F;
-		g_eeprom.vfo_info[VFO].freq_config_tx.code_type = (Data[2] >> 4) & 0x0F;
-
-		Tmp = Data[0];
-		switch (g_eeprom.vfo_info[VFO].freq_config_rx.code_type)
-		{
-			default:
-			case CODE_TYPE_OFF:
-				g_eeprom.vfo_info[VFO].freq_config_rx.code_type = CODE_TYPE_OFF;
-				Tmp = 0;
-				break;
-
-			case CODE_TYPE_CONTINUOUS_TONE:
-				if (Tmp > (ARRAY_SIZE(CTCSS_OPTIONS) - 1))
-					Tmp = 0;
-				break;
-
-			case CODE_TYPE_DIGITAL:
-			case CODE_TYPE_REVERSE_DIGITAL:
-				if (Tmp > (ARRAY_SIZE(DCS_OPTIONS) - 1))
-					Tmp = 0;
-				break;
-		}
-		g_eeprom.vfo_info[VFO].freq_config_rx.code = Tmp;
-
-		Tmp = Data[1];
-		switch (g_eeprom.vfo_info[VFO].freq_config_tx.code_type)
-		{
-			default:
-			case CODE_TYPE_OFF:
-				g_eeprom.vfo_info[VFO].freq_config_tx.code_type = CODE_TYPE_OFF;
-				Tmp = 0;
-				break;
+		const channel_index_t *pEntry;
+		channel_index_t        entry;
 
-			case CODE_TYPE_CONTINUOUS_TONE:
-				if (Tmp > (ARRAY_SIZE(CTCSS_OPTIONS) - 1))
-					Tmp = 0;
-				break;
-
-			case CODE_TYPE_DIGITAL:
-			case CODE_TYPE_REVERSE_DIGITAL:
-				if (Tmp > (ARRAY_SIZE(DCS_OPTIONS) - 1))
-					Tmp = 0;
-				break;
-		}
-		g_eeprom.vfo_info[VFO].freq_config_tx.code = Tmp;
-
-		if (Data[4] == 0xFF)
-		{
-			g_eeprom.vfo_info[VFO].frequency_reverse = false;
-			g_eeprom.vfo_info[VFO].channel_bandwidth = BK4819_FILTER_BW_WIDE;
-			g_eeprom.vfo_info[VFO].output_power      = OUTPUT_POWER_LOW;
-			g_eeprom.vfo_info[VFO].busy_channel_lock = false;
-		}
-		else
-		{
-			const uint8_t d4 = Data[4];
-			g_eeprom.vfo_info[VFO].frequency_reverse = ((d4 >> 0) & 1u) ? true : false;
-			g_eeprom.vfo_info[VFO].channel_bandwidth = ((d4 >> 1) & 1u) ? true : false;
-			g_eeprom.vfo_info[VFO].output_power      =  (d4 >> 2) & 3u;
-			g_eeprom.vfo_info[VFO].busy_channel_lock = ((d4 >> 4) & 1u) ? true : false;
-		}
-
-		if (Data[5] == 0xFF)
+		if (Channel <= USER_CHANNEL_LAST)
 		{
-			g_eeprom.vfo_info[VFO].dtmf_decoding_enable = false;
-			g_eeprom.vfo_info[VFO].dtmf_ptt_id_tx_mode  = PTT_ID_OFF;
+			pEntry = RADIO_GetChannelIndex(Channel, &entry);
 		}
 		else
-		{
-			g_eeprom.vfo_info[VFO].dtmf_decoding_enable = ((Data[5] >> 0) & 1u) ? true : false;
-			g_eeprom.vfo_info[VFO].dtmf_ptt_id_tx_mode  = ((Data[5] >> 1) & 7u);
+		{	// VFO's aren't indexed
+			uint8_t Data[16];
+			EEPROM_ReadBuffer(Base, Data, sizeof(Data));
+			RADIO_PackChannel(&entry, Data);
+			pEntry = &entry;
 		}
 
-		// ***************
-
-		struct
-		{
-			uint32_t frequency;
-			uint32_t offset;
-		} __attribute__((packed)) info;
-
-		EEPROM_ReadBuffer(Base, &info, sizeof(info));
-
-		pRadio->freq_config_rx.frequency = info.frequency;
-
-		if (info.offset >= 100000000)
-			info.offset = 1000000;
-		g_eeprom.vfo_info[VFO].tx_offset_freq = info.offset;
-
-		// ***************
+		g_eeprom.vfo_info[VFO].tx_offset_freq_dir       = pEntry->tx_offset_freq_dir;
+		g_eeprom.vfo_info[VFO].am_mode                  = pEntry->am_mode;
+		g_eeprom.vfo_info[VFO].step_setting             = pEntry->step_setting;
+		g_eeprom.vfo_info[VFO].step_freq                = STEP_FREQ_TABLE[pEntry->step_setting];
+		g_eeprom.vfo_info[VFO].scrambling_type          = pEntry->scrambling_type;
+		g_eeprom.vfo_info[VFO].freq_config_rx.code_type = pEntry->rx_code_type;
+		g_eeprom.vfo_info[VFO].freq_config_rx.code      = pEntry->rx_code;
+		g_eeprom.vfo_info[VFO].freq_config_tx.code_type = pEntry->tx_code_type;
+		g_eeprom.vfo_info[VFO].freq_config_tx.code      = pEntry->tx_code;
+		g_eeprom.vfo_info[VFO].frequency_reverse        = pEntry->frequency_reverse;
+		g_eeprom.vfo_info[VFO].channel_bandwidth        = pEntry->channel_bandwidth;
+		g_eeprom.vfo_info[VFO].output_power             = pEntry->output_power;
+		g_eeprom.vfo_info[VFO].busy_channel_lock        = pEntry->busy_channel_lock;
+		g_eeprom.vfo_info[VFO].dtmf_decoding_enable     = pEntry->dtmf_decoding_enable;
+		g_eeprom.vfo_info[VFO].dtmf_ptt_id_tx_mode      = pEntry->dtmf_ptt_id_tx_mode;
+
+		pRadio->freq_config_rx.frequency                = pEntry->frequency;
+		g_eeprom.vfo_info[VFO].tx_offset_freq           = pEntry->tx_offset_freq;
 	}
 
 	Frequency = pRadio->freq_config_rx.frequency;
@@ -386,10 +682,10 @@ void RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure
 	RADIO_ApplyOffset(pRadio);
 
 	memset(g_eeprom.vfo_info[VFO].name, 0, sizeof(g_eeprom.vfo_info[VFO].name));
-	if (Channel < USER_CHANNEL_LAST)
+	if (Channel < USER_CHANNEL_LAST && g_scan_state_dir == SCAN_OFF)
 	{	// 16 bytes allocated to the channel name but only 10 used, the rest are 0's
-		EEPROM_ReadBuffer(0x0F50 + (Channel * 16), g_eeprom.vfo_info[VFO].name + 0, 8);
-		EEPROM_ReadBuffer(0x0F58 + (Channel * 16), g_eeprom.vfo_info[VFO].name + 8, 2);
+		// .. the display fetches the name itself, so don't spend a scan hop on it
+		EEPROM_ReadBuffer(0x0F50 + (Channel * 16), g_eeprom.vfo_info[VFO].name, 10);
 	}
 
 	if (!g_eeprom.vfo_info[VFO].frequency_reverse)
@@ -432,7 +728,6 @@ void RADIO_ConfigureSquelchAndOutputPower(vfo_info_t *pInfo)
 	// squelch
 
 	Band = FREQUENCY_GetBand(pInfo->pRX->frequency);
-	uint16_t Base = (Band < BAND4_174MHz) ? 0x1E60 : 0x1E00;
 
 	if (g_eeprom.squelch_level == 0)
 	{	// squelch == 0 (off)
@@ -446,16 +741,17 @@ void RADIO_ConfigureSquelchAndOutputPower(vfo_info_t *pInfo)
 	}
 	else
 	{	// squelch >= 1
-		Base += g_eeprom.squelch_level;                                        // my eeprom squelch-1
-																			  // VHF   UHF
-		EEPROM_ReadBuffer(Base + 0x00, &pInfo->squelch_open_rssi_thresh,    1);  //  50    10
-		EEPROM_ReadBuffer(Base + 0x10, &pInfo->squelch_close_rssi_thresh,   1);  //  40     5
+		const uint8_t *pThresh = RADIO_GetSquelchThresholds((Band < BAND4_174MHz) ? 0 : 1);
+		                                                           // my eeprom squelch-1
+		                                                           // VHF   UHF
+		pInfo->squelch_open_rssi_thresh    = pThresh[0];           //  50    10
+		pInfo->squelch_close_rssi_thresh   = pThresh[1];           //  40     5
 
-		EEPROM_ReadBuffer(Base + 0x20, &pInfo->squelch_open_noise_thresh,   1);  //  65    90
-		EEPROM_ReadBuffer(Base + 0x30, &pInfo->squelch_close_noise_thresh,  1);  //  70   100
+		pInfo->squelch_open_noise_thresh   = pThresh[2];           //  65    90
+		pInfo->squelch_close_noise_thresh  = pThresh[3];           //  70   100
 
-		EEPROM_ReadBuffer(Base + 0x40, &pInfo->squelch_close_glitch_thresh, 1);  //  90    90
-		EEPROM_ReadBuffer(Base + 0x50, &pInfo->squelch_open_glitch_thresh,  1);  // 100   100
+		pInfo->squelch_close_glitch_thresh = pThresh[4];           //  90    90
+		pInfo->squelch_open_glitch_thresh  = pThresh[5];           // 100   100
 
 		uint16_t rssi_open    = pInfo->squelch_open_rssi_thresh;
 		uint16_t rssi_close   = pInfo->squelch_close_rssi_thresh;
@@ -524,7 +820,13 @@ void RADIO_ConfigureSquelchAndOutputPower(vfo_info_t *pInfo)
 
 	Band = FREQUENCY_GetBand(pInfo->pTX->frequency);
 
-	EEPROM_ReadBuffer(0x1ED0 + (Band * 16) + (pInfo->output_power * 3), TX_power, 3);
+	RADIO_CheckChannelIndex();
+	if ((txp_cache_valid & (1u << Band)) == 0)
+	{
+		EEPROM_ReadBuffer(0x1ED0 + (Band * 16), txp_cache[Band], sizeof(txp_cache[Band]));
+		txp_cache_valid |= 1u << Band;
+	}
+	memmove(TX_power, &txp_cache[Band][pInfo->output_power * 3], sizeof(TX_power));
 
 	pInfo->txp_calculated_setting = FREQUENCY_CalculateOutputPower(
 		TX_power[0],
@@ -585,6 +887,10 @@ void RADIO_SetupRegisters(bool bSwitchToFunction0)
 	uint16_t                 InterruptMask;
 	uint32_t                 Frequency;
 
+	#ifdef ENABLE_PROFILER
+		const uint32_t start = PROFILER_Stamp();
+	#endif
+
 	GPIO_ClearBit(&GPIOC->DATA, GPIOC_PIN_AUDIO_PATH);
 
 	g_enable_speaker = false;
@@ -626,10 +932,16 @@ void RADIO_SetupRegisters(bool bSwitchToFunction0)
 		BK4819_WriteRegister(BK4819_REG_02, 0);
 		SYSTEM_DelayMs(1);
 	}
-	BK4819_WriteRegister(BK4819_REG_3F, 0);
+	{
+		const BK4819_reg_val_t regs[] =
+		{
+			{BK4819_REG_3F, 0},
 
-	// mic gain 0.5dB/step 0 to 31
-	BK4819_WriteRegister(BK4819_REG_7D, 0xE940 | (g_eeprom.mic_sensitivity_tuning & 0x1f));
+			// mic gain 0.5dB/step 0 to 31
+			{BK4819_REG_7D, 0xE940 | (g_eeprom.mic_sensitivity_tuning & 0x1f)}
+		};
+		BK4819_WriteRegisters(regs, ARRAY_SIZE(regs));
+	}
 
 	#ifdef ENABLE_NOAA
 		if (IS_NOT_NOAA_CHANNEL(g_rx_vfo->channel_save) || !g_is_noaa_mode)
@@ -788,6 +1100,10 @@ void RADIO_SetupRegisters(bool bSwitchToFunction0)
 
 	if (bSwitchToFunction0)
 		FUNCTION_Select(FUNCTION_FOREGROUND);
+
+	#ifdef ENABLE_PROFILER
+		PROFILER_Record(PROFILE_SETUP_REGISTERS, start);
+	#endif
 }
 
 #ifdef ENABLE_NOAA
@@ -824,7 +1140,7 @@ void RADIO_SetupRegisters(bool bSwitchToFunction0)
 			{
 				g_is_noaa_mode          = true;
 				g_noaa_channel         = g_rx_vfo->channel_save - NOAA_CHANNEL_FIRST;
-				g_noaa_count_down_10ms = noaa_count_down_2_10ms;
+				SCHEDULER_StartTimer(TIMER_NOAA, noaa_count_down_2_10ms);
 				g_schedule_noaa        = false;
 			}
 			else
@@ -941,7 +1257,7 @@ void RADIO_PrepareTX(void)
 	if (g_eeprom.dual_watch != DUAL_WATCH_OFF)
 	{	// dual-RX is enabled
 
-		g_dual_watch_count_down_10ms = dual_watch_count_after_tx_10ms;
+		SCHEDULER_StartTimer(TIMER_DUAL_WATCH, dual_watch_count_after_tx_10ms);
 		g_schedule_dual_watch       = false;
 
 #if 0
@@ -1029,19 +1345,19 @@ void RADIO_PrepareTX(void)
 
 	FUNCTION_Select(FUNCTION_TRANSMIT);
 
-	g_tx_timer_count_down_500ms = 0;            // no timeout
+	SCHEDULER_StopTimer(TIMER_TX_TIMEOUT);            // no timeout
 
 	#if defined(ENABLE_ALARM) || defined(ENABLE_TX1750)
 		if (g_alarm_state == ALARM_STATE_OFF)
 	#endif
 	{
 		if (g_eeprom.tx_timeout_timer == 0)
-			g_tx_timer_count_down_500ms = 60;   // 30 sec
+			SCHEDULER_StartTimer(TIMER_TX_TIMEOUT, 60);   // 30 sec
 		else
 		if (g_eeprom.tx_timeout_timer < (ARRAY_SIZE(g_sub_menu_TOT) - 1))
-			g_tx_timer_count_down_500ms = 120 * g_eeprom.tx_timeout_timer;  // minutes
+			SCHEDULER_StartTimer(TIMER_TX_TIMEOUT, 120 * g_eeprom.tx_timeout_timer);  // minutes
 		else
-			g_tx_timer_count_down_500ms = 120 * 15;  // 15 minutes
+			SCHEDULER_StartTimer(TIMER_TX_TIMEOUT, 120 * 15);  // 15 minutes
 	}
 	g_tx_timeout_reached    = false;
 
@@ -116,6 +116,33 @@ typedef struct vfo_info_t
 	char           name[16];
 } vfo_info_t;
 
+// one memory channel, as RADIO_ConfigureChannel() wants it
+#define CHANNEL_INDEX_FREQ_MAX  ((1u << 27) - 1)
+
+typedef struct
+{
+	uint32_t frequency            : 27;
+	uint32_t rx_code_type         : 2;
+	uint32_t tx_code_type         : 2;
+	uint32_t am_mode              : 1;
+
+	uint32_t tx_offset_freq       : 27;
+	uint32_t tx_offset_freq_dir   : 2;
+	uint32_t frequency_reverse    : 1;
+	uint32_t channel_bandwidth    : 1;
+	uint32_t busy_channel_lock    : 1;
+
+	uint8_t  rx_code;
+	uint8_t  tx_code;
+
+	uint16_t output_power         : 2;
+	uint16_t dtmf_decoding_enable : 1;
+	uint16_t dtmf_ptt_id_tx_mode  : 3;
+	uint16_t step_setting         : 3;
+	uint16_t scrambling_type      : 4;
+	uint16_t valid                : 1;   // clear till it's (re-)read from the EEPROM
+} channel_index_t;
+
 extern vfo_info_t     *g_tx_vfo;
 extern vfo_info_t     *g_rx_vfo;
 extern vfo_info_t     *g_current_vfo;
@@ -131,6 +158,11 @@ extern vfo_state_t     g_vfo_state[2];
 bool     RADIO_CheckValidChannel(uint16_t ChNum, bool bCheckScanList, uint8_t RadioNum);
 uint8_t  RADIO_FindNextChannel(uint8_t ChNum, scan_state_dir_t Direction, bool bCheckScanList, uint8_t RadioNum);
 void     RADIO_InitInfo(vfo_info_t *pInfo, const uint8_t ChannelSave, const uint32_t Frequency);
+void     RADIO_UpdateScanLists(const unsigned int Channel);   // after its attributes change
+void     RADIO_BuildScanLists(void);
+void     RADIO_BuildChannelIndex(void);
+void     RADIO_InvalidateChannelIndex(const unsigned int Channel);
+bool     RADIO_GetIndexedFrequency(const unsigned int Channel, uint32_t *pFrequency);   // false if it isn't indexed
 void     RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure);
 void     RADIO_ConfigureSquelchAndOutputPower(vfo_info_t *pInfo);
 void     RADIO_ApplyOffset(vfo_info_t *pInfo);
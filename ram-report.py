@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+
+# prints the .data/.bss each module puts in RAM, from the linker map
+#
+#   ram-report.py firmware.map
+#
+# with LTO the code is re-partitioned before it's linked, so the map only
+# knows the ltrans partitions .. build with ENABLE_LTO=0 to see modules
+
+import re
+import sys
+
+from collections import defaultdict
+
+RAM_ORIGIN = 0x20000000
+STACK_TOP  = 0x20003FF0   # as set by HandlerReset
+
+# " .bss.name   0x20000010   0x20 app/app.o", the section name can be on a line of its own
+INPUT   = re.compile(r'^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+OUTPUT  = re.compile(r'^(\.\S+)')
+BSS_END = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+__bss_end__ = ')
+
+def parse(path):
+    usage   = defaultdict(lambda: [0, 0])
+    bss_end = None
+    output  = None
+    pending = None
+    in_map  = False
+
+    for line in open(path):
+        line = line.rstrip('\n')
+
+        if line.startswith('Linker script and memory map'):
+            in_map = True
+            continue
+        if not in_map:
+            continue
+
+        match = BSS_END.match(line)
+        if match:
+            bss_end = int(match.group(1), 16)
+            continue
+
+        match = OUTPUT.match(line)
+        if match:
+            output = match.group(1)
+            continue
+
+        if output not in ('.data', '.bss'):
+            continue
+
+        if re.match(r'^ \S+$', line):
+            pending = line.strip()   # the name's too long, the rest is on the next line
+            continue
+
+        match = INPUT.match(line)
+        if not match:
+            pending = None
+            continue
+
+        name = match.group(1) or pending
+        pending = None
+        if name is None or name.startswith('*') or name == '*fill*':
+            continue
+
+        size = int(match.group(3), 16)
+        if size == 0:
+            continue
+
+        usage[match.group(4).strip()][0 if output == '.data' else 1] += size
+
+    return usage, bss_end
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        sys.exit('usage: %s firmware.map' % sys.argv[0])
+
+    usage, bss_end = parse(sys.argv[1])
+    data  = sum(u[0] for u in usage.values())
+    bss   = sum(u[1] for u in usage.values())
+
+    print('%6s %6s %6s  %s' % ('data', 'bss', 'total', 'module'))
+    for name, (d, b) in sorted(usage.items(), key=lambda item: -(item[1][0] + item[1][1])):
+        print('%6u %6u %6u  %s' % (d, b, d + b, name))
+
+    # the map's own idea of the end of .bss includes the alignment padding
+    stack = STACK_TOP - (bss_end if bss_end is not None else (RAM_ORIGIN + data + bss))
+    print()
+    print('%6u bytes .data + .bss' % (data + bss))
+    print('%6u bytes left for the stack, below 0x%08X' % (stack, STACK_TOP))
@@ -14,6 +14,9 @@
  *     limitations under the License.
  */
 
+#include <stdio.h>     // NULL
+
+#include "ARMCM0.h"
 #ifdef ENABLE_FMRADIO
 	#include "app/fm.h"
 #endif
@@ -22,92 +25,155 @@
 #include "functions.h"
 #include "helper/battery.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 
 #include "driver/backlight.h"
 #include "bsp/dp32g030/gpio.h"
 #include "driver/gpio.h"
 
-#define DECREMENT(cnt) \
-	do {               \
-		if (cnt > 0)   \
-			cnt--;     \
-	} while (0)
+typedef struct {
+	volatile uint16_t *pCount;
+	volatile bool     *pFlag;     // set when the count reaches zero, NULL if nobody's waiting on it
+} scheduler_entry_t;
+
+static const scheduler_entry_t timers[TIMER_COUNT] = {
+	[TIMER_TX_TIMEOUT]    = {&g_tx_timer_count_down_500ms,             &g_tx_timeout_reached},
+	[TIMER_SERIAL_CONFIG] = {&g_serial_config_count_down_500ms,        NULL},
+	[TIMER_FOUND_CDCSS]   = {&g_found_CDCSS_count_down_10ms,           NULL},
+	[TIMER_FOUND_CTCSS]   = {&g_found_CTCSS_count_down_10ms,           NULL},
+	[TIMER_BATTERY_SAVE]  = {&g_battery_save_count_down_10ms,          &g_schedule_power_save},
+	[TIMER_POWER_SAVE]    = {&g_power_save_10ms,                       &g_power_save_expired},
+	[TIMER_DUAL_WATCH]    = {&g_dual_watch_count_down_10ms,            &g_schedule_dual_watch},
+	[TIMER_SCAN_PAUSE]    = {&g_scan_pause_delay_in_10ms,              &g_schedule_scan_listen},
+	[TIMER_TAIL_TONE]     = {&g_tail_tone_elimination_count_down_10ms, &g_flag_tail_tone_elimination_complete},
+	[TIMER_BOOT]          = {&g_boot_counter_10ms,                     NULL},
+#ifdef ENABLE_NOAA
+	[TIMER_NOAA]          = {&g_noaa_count_down_10ms,                  &g_schedule_noaa},
+#endif
+#ifdef ENABLE_VOICE
+	[TIMER_VOICE]         = {&g_count_down_to_play_next_voice_10ms,    &g_flag_play_queued_voice},
+#endif
+#ifdef ENABLE_FMRADIO
+	[TIMER_FM_PLAY]       = {&g_fm_play_count_down_10ms,               &g_schedule_fm},
+#endif
+#ifdef ENABLE_VOX
+	[TIMER_VOX_STOP]      = {&g_vox_stop_count_down_10ms,              NULL},
+#endif
+};
+
+volatile uint32_t        g_global_sys_tick_counter;
+static volatile uint32_t timers_running = 1u << TIMER_BATTERY_SAVE;   // bit per timer, the tick only looks at these (the battery save count starts loaded)
+
+void SCHEDULER_StartTimer(const scheduler_timer_t timer, const uint16_t ticks)
+{	// callers may already have the interrupts off (UART_HandleCommand), leave them as they were
+	const uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
 
-#define DECREMENT_AND_TRIGGER(cnt, flag) \
-	do {                                 \
-		if (cnt > 0)                     \
-			if (--cnt == 0)              \
-				flag = true;             \
-	} while (0)
+	*timers[timer].pCount = ticks;
 
-static volatile uint32_t g_global_sys_tick_counter;
+	if (ticks > 0)
+		timers_running |=   1u << timer;
+	else
+		timers_running &= ~(1u << timer);
 
-void SystickHandler(void);
+	__set_PRIMASK(primask);
+}
+
+void SCHEDULER_StopTimer(const scheduler_timer_t timer)
+{
+	SCHEDULER_StartTimer(timer, 0);
+}
+
+// whether a running timer counts down this tick, most only count while the radio's
+// not busy with whatever it is they're waiting to do
+static bool SCHEDULER_TimerCounts(const unsigned int timer, const bool tick_500ms)
+{
+	switch (timer)
+	{
+		case TIMER_TX_TIMEOUT:
+		case TIMER_SERIAL_CONFIG:
+			return tick_500ms;
+
+		case TIMER_BATTERY_SAVE:
+			return (g_current_function == FUNCTION_FOREGROUND) ? true : false;
+
+		case TIMER_POWER_SAVE:
+			return (g_current_function == FUNCTION_POWER_SAVE) ? true : false;
+
+		case TIMER_DUAL_WATCH:
+			return (g_scan_state_dir == SCAN_OFF && g_css_scan_mode == CSS_SCAN_MODE_OFF && g_eeprom.dual_watch != DUAL_WATCH_OFF &&
+			        g_current_function != FUNCTION_MONITOR && g_current_function != FUNCTION_TRANSMIT && g_current_function != FUNCTION_RECEIVE) ? true : false;
+
+		#ifdef ENABLE_NOAA
+			case TIMER_NOAA:
+				return (g_scan_state_dir == SCAN_OFF && g_css_scan_mode == CSS_SCAN_MODE_OFF && g_eeprom.dual_watch == DUAL_WATCH_OFF &&
+				        g_is_noaa_mode && g_current_function != FUNCTION_MONITOR && g_current_function != FUNCTION_TRANSMIT && g_current_function != FUNCTION_RECEIVE) ? true : false;
+		#endif
+
+		case TIMER_SCAN_PAUSE:
+			return ((g_scan_state_dir != SCAN_OFF || g_css_scan_mode == CSS_SCAN_MODE_SCANNING) &&
+			        g_current_function != FUNCTION_MONITOR && g_current_function != FUNCTION_TRANSMIT) ? true : false;
+
+		#ifdef ENABLE_FMRADIO
+			case TIMER_FM_PLAY:
+				return (g_fm_scan_state != FM_SCAN_OFF &&
+				        g_current_function != FUNCTION_MONITOR && g_current_function != FUNCTION_TRANSMIT && g_current_function != FUNCTION_RECEIVE) ? true : false;
+		#endif
+
+		default:
+			return true;
+	}
+}
 
 // we come here every 10ms
 void SystickHandler(void)
 {
+	uint32_t     running;
+	unsigned int timer;
+	bool         tick_500ms;
+
 	g_global_sys_tick_counter++;
-	
-	g_next_time_slice = true;
 
-	if ((g_global_sys_tick_counter % 50) == 0)
-	{	// 500ms tick
+	g_next_time_slice = true;
 
+	tick_500ms = ((g_global_sys_tick_counter % 50) == 0) ? true : false;
+	if (tick_500ms)
 		g_next_time_slice_500ms = true;
-		
-		DECREMENT_AND_TRIGGER(g_tx_timer_count_down_500ms, g_tx_timeout_reached);
-		DECREMENT(g_serial_config_count_down_500ms);
-	}
 
 	if ((g_global_sys_tick_counter & 3) == 0)
 		g_next_time_slice_40ms = true;
 
-	#ifdef ENABLE_NOAA
-		DECREMENT(g_noaa_count_down_10ms);
-	#endif
-
-	DECREMENT(g_found_CDCSS_count_down_10ms);
-
-	DECREMENT(g_found_CTCSS_count_down_10ms);
-
-	if (g_current_function == FUNCTION_FOREGROUND)
-		DECREMENT_AND_TRIGGER(g_battery_save_count_down_10ms, g_schedule_power_save);
-
-	if (g_current_function == FUNCTION_POWER_SAVE)
-		DECREMENT_AND_TRIGGER(g_power_save_10ms, g_power_save_expired);
-
-	if (g_scan_state_dir == SCAN_OFF && g_css_scan_mode == CSS_SCAN_MODE_OFF && g_eeprom.dual_watch != DUAL_WATCH_OFF)
-		if (g_current_function != FUNCTION_MONITOR && g_current_function != FUNCTION_TRANSMIT && g_current_function != FUNCTION_RECEIVE)
-			DECREMENT_AND_TRIGGER(g_dual_watch_count_down_10ms, g_schedule_dual_watch);
-
-	#ifdef ENABLE_NOAA
-		if (g_scan_state_dir == SCAN_OFF && g_css_scan_mode == CSS_SCAN_MODE_OFF && g_eeprom.dual_watch == DUAL_WATCH_OFF)
-			if (g_is_noaa_mode && g_current_function != FUNCTION_MONITOR && g_current_function != FUNCTION_TRANSMIT)
-				if (g_current_function != FUNCTION_RECEIVE)
-					DECREMENT_AND_TRIGGER(g_noaa_count_down_10ms, g_schedule_noaa);
-	#endif
-
-	if (g_scan_state_dir != SCAN_OFF || g_css_scan_mode == CSS_SCAN_MODE_SCANNING)
-		if (g_current_function != FUNCTION_MONITOR && g_current_function != FUNCTION_TRANSMIT)
-			DECREMENT_AND_TRIGGER(g_scan_pause_delay_in_10ms, g_schedule_scan_listen);
-
-	DECREMENT_AND_TRIGGER(g_tail_tone_elimination_count_down_10ms, g_flag_tail_tone_elimination_complete);
-
-	#ifdef ENABLE_VOICE
-		DECREMENT_AND_TRIGGER(g_count_down_to_play_next_voice_10ms, g_flag_play_queued_voice);
-	#endif
-	
-	#ifdef ENABLE_FMRADIO
-		if (g_fm_scan_state != FM_SCAN_OFF && g_current_function != FUNCTION_MONITOR)
-			if (g_current_function != FUNCTION_TRANSMIT && g_current_function != FUNCTION_RECEIVE)
-				DECREMENT_AND_TRIGGER(g_fm_play_count_down_10ms, g_schedule_fm);
-	#endif
-
-	#ifdef ENABLE_VOX
-		DECREMENT(g_vox_stop_count_down_10ms);
-	#endif
-
-	DECREMENT(g_boot_counter_10ms);
+	// only the running timers
+	running = timers_running;
+	for (timer = 0; running != 0; timer++, running >>= 1)
+	{
+		const scheduler_entry_t *pTimer = &timers[timer];
+
+		if ((running & 1u) == 0)
+			continue;
+
+		#ifdef ENABLE_NOAA
+			if (timer == TIMER_NOAA && *pTimer->pCount > 0)
+				if (--(*pTimer->pCount) == 0)   // the NOAA countdown also runs down (without firing) while it's held off
+					timers_running &= ~(1u << timer);
+		#endif
+
+		if (*pTimer->pCount == 0)
+		{
+			timers_running &= ~(1u << timer);
+			continue;
+		}
+
+		if (!SCHEDULER_TimerCounts(timer, tick_500ms))
+			continue;
+
+		if (--(*pTimer->pCount) == 0)
+		{
+			timers_running &= ~(1u << timer);
+			if (pTimer->pFlag != NULL)
+				*pTimer->pFlag = true;
+		}
+	}
 }
@@ -0,0 +1,58 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+// the countdown timers the 10ms systick runs .. each one counts its g_xxx_count_down
+// variable to zero (pausing while whatever it waits on is busy), then sets its flag
+enum scheduler_timer_e {
+	TIMER_TX_TIMEOUT = 0,   // 500ms ticks
+	TIMER_SERIAL_CONFIG,    // 500ms ticks
+	TIMER_FOUND_CDCSS,
+	TIMER_FOUND_CTCSS,
+	TIMER_BATTERY_SAVE,
+	TIMER_POWER_SAVE,
+	TIMER_DUAL_WATCH,
+	TIMER_SCAN_PAUSE,
+	TIMER_TAIL_TONE,
+	TIMER_BOOT,
+#ifdef ENABLE_NOAA
+	TIMER_NOAA,
+#endif
+#ifdef ENABLE_VOICE
+	TIMER_VOICE,
+#endif
+#ifdef ENABLE_FMRADIO
+	TIMER_FM_PLAY,
+#endif
+#ifdef ENABLE_VOX
+	TIMER_VOX_STOP,
+#endif
+	TIMER_COUNT
+};
+typedef enum scheduler_timer_e scheduler_timer_t;
+
+extern volatile uint32_t g_global_sys_tick_counter;   // 10ms ticks since boot
+
+void     SCHEDULER_StartTimer(const scheduler_timer_t timer, const uint16_t ticks);
+void     SCHEDULER_StopTimer(const scheduler_timer_t timer);
+
+void     SystickHandler(void);
+
+#endif
@@ -26,11 +26,68 @@
 
 eeprom_config_t g_eeprom;
 
+uint32_t        g_settings_writes_skipped;
+
+// last image persisted of each settings block, so a save only writes the ones
+// that actually changed .. filled in from the EEPROM the first time each block
+// is saved, and dropped whenever something else writes the EEPROM directly
+static uint8_t  settings_shadow[18][8];
+static uint32_t settings_shadow_valid;
+static uint16_t settings_shadow_writes;   // g_eeprom_direct_writes when the shadow was last good
+
+static int SETTINGS_ShadowIndex(const uint16_t Address)
+{
+	if (Address >= 0x0E40 && Address < 0x0EB0)   // FM channels .. 0x0EA8 block
+		return (Address - 0x0E40) / 8;
+	if (Address >= 0x0ED0 && Address < 0x0EE0)   // DTMF settings
+		return 14 + ((Address - 0x0ED0) / 8);
+	if (Address == 0x0F18)                        // scan lists
+		return 16;
+	if (Address == 0x0F40)                        // misc/tx enables
+		return 17;
+	return -1;
+}
+
+static void SETTINGS_WriteBlocks(uint16_t Address, const void *pBuffer, unsigned int Size)
+{
+	const uint8_t *pData = (const uint8_t *)pBuffer;
+
+	if (settings_shadow_writes != g_eeprom_direct_writes)
+	{
+		settings_shadow_writes = g_eeprom_direct_writes;
+		settings_shadow_valid  = 0;
+	}
+
+	for ( ; Size >= 8; Address += 8, pData += 8, Size -= 8)
+	{
+		const int index = SETTINGS_ShadowIndex(Address);
+
+		if (index >= 0)
+		{
+			uint8_t *pShadow = settings_shadow[index];
+
+			if ((settings_shadow_valid & (1u << index)) == 0)
+			{
+				EEPROM_ReadBuffer(Address, pShadow, 8);
+				settings_shadow_valid |= 1u << index;
+			}
+
+			if (memcmp(pShadow, pData, 8) == 0)
+			{
+				g_settings_writes_skipped++;
+				continue;
+			}
+
+			memcpy(pShadow, pData, 8);
+		}
+
+		EEPROM_QueueWrite(Address, pData, 8);
+	}
+}
+
 #ifdef ENABLE_FMRADIO
 	void SETTINGS_SaveFM(void)
 	{
-		unsigned int i;
-
 		struct
 		{
 			uint16_t frequency;
@@ -44,10 +101,9 @@ eeprom_config_t g_eeprom;
 		state.frequency           = g_eeprom.fm_selected_frequency;
 		state.is_channel_selected = g_eeprom.fm_is_channel_mode;
 
-		EEPROM_WriteBuffer(0x0E88, &state);
+		SETTINGS_WriteBlocks(0x0E88, &state, sizeof(state));
 
-		for (i = 0; i < 5; i++)
-			EEPROM_WriteBuffer(0x0E40 + (i * 8), &g_fm_channels[i * 4]);
+		SETTINGS_WriteBlocks(0x0E40, g_fm_channels, sizeof(g_fm_channels));
 	}
 #endif
 
@@ -70,7 +126,7 @@ void SETTINGS_SaveVfoIndices(void)
 		State[7] = g_eeprom.noaa_channel[1];
 	#endif
 
-	EEPROM_WriteBuffer(0x0E80, State);
+	SETTINGS_WriteBlocks(0x0E80, State, sizeof(State));
 }
 
 // *************************************************
@@ -209,7 +265,7 @@ void SETTINGS_SaveSettings(void)
 		State[6] = 0;
 	#endif
 	State[7] = g_eeprom.mic_sensitivity;
-	EEPROM_WriteBuffer(0x0E70, State);
+	SETTINGS_WriteBlocks(0x0E70, State, sizeof(State));
 
 	//State[0] = 0xFF;
 	State[0] = g_setting_contrast;
@@ -220,7 +276,7 @@ void SETTINGS_SaveSettings(void)
 	State[5] = g_eeprom.backlight;
 	State[6] = g_eeprom.tail_note_elimination;
 	State[7] = g_eeprom.vfo_open;
-	EEPROM_WriteBuffer(0x0E78, State);
+	SETTINGS_WriteBlocks(0x0E78, State, sizeof(State));
 
 	State[0] = g_eeprom.beep_control;
 	State[1] = g_eeprom.key1_short_press_action;
@@ -230,7 +286,7 @@ void SETTINGS_SaveSettings(void)
 	State[5] = g_eeprom.scan_resume_mode;
 	State[6] = g_eeprom.auto_keypad_lock;
 	State[7] = g_eeprom.pwr_on_display_mode;
-	EEPROM_WriteBuffer(0x0E90, State);
+	SETTINGS_WriteBlocks(0x0E90, State, sizeof(State));
 
 	{
 		struct {
@@ -243,13 +299,13 @@ void SETTINGS_SaveSettings(void)
 			array.password = g_eeprom.power_on_password;
 		#endif
 
-		EEPROM_WriteBuffer(0x0E98, &array);
+		SETTINGS_WriteBlocks(0x0E98, &array, sizeof(array));
 	}
 
 	#ifdef ENABLE_VOICE
 		memset(State, 0xFF, sizeof(State));
 		State[0] = g_eeprom.voice_prompt;
-		EEPROM_WriteBuffer(0x0EA0, State);
+		SETTINGS_WriteBlocks(0x0EA0, State, sizeof(State));
 	#endif
 
 	// *****************************
@@ -278,7 +334,7 @@ void SETTINGS_SaveSettings(void)
 			array.air_copy_freq              = g_aircopy_freq;
 		#endif
 
-		EEPROM_WriteBuffer(0x0EA8, &array);
+		SETTINGS_WriteBlocks(0x0EA8, &array, sizeof(array));
 	}
 
 	State[0] = g_eeprom.dtmf_side_tone;
@@ -289,13 +345,13 @@ void SETTINGS_SaveSettings(void)
 	State[5] = g_eeprom.dtmf_preload_time / 10U;
 	State[6] = g_eeprom.dtmf_first_code_persist_time / 10U;
 	State[7] = g_eeprom.dtmf_hash_code_persist_time / 10U;
-	EEPROM_WriteBuffer(0x0ED0, State);
+	SETTINGS_WriteBlocks(0x0ED0, State, sizeof(State));
 
 	memset(State, 0xFF, sizeof(State));
 	State[0] = g_eeprom.dtmf_code_persist_time / 10U;
 	State[1] = g_eeprom.dtmf_code_interval_time / 10U;
 	State[2] = g_eeprom.permit_remote_kill;
-	EEPROM_WriteBuffer(0x0ED8, State);
+	SETTINGS_WriteBlocks(0x0ED8, State, sizeof(State));
 
 	State[0] = g_eeprom.scan_list_default;
 	State[1] = g_eeprom.scan_list_enabled[0];
@@ -305,7 +361,7 @@ void SETTINGS_SaveSettings(void)
 	State[5] = g_eeprom.scan_list_priority_ch1[1];
 	State[6] = g_eeprom.scan_list_priority_ch2[1];
 	State[7] = 0xFF;
-	EEPROM_WriteBuffer(0x0F18, State);
+	SETTINGS_WriteBlocks(0x0F18, State, sizeof(State));
 
 	memset(State, 0xFF, sizeof(State));
 	State[0]  = g_setting_freq_lock;
@@ -326,14 +382,14 @@ void SETTINGS_SaveSettings(void)
 	#endif
 	State[7] = (State[7] & ~(3u << 6)) | ((g_setting_backlight_on_tx_rx & 3u) << 6);
 
-	EEPROM_WriteBuffer(0x0F40, State);
+	SETTINGS_WriteBlocks(0x0F40, State, sizeof(State));
 }
 
 void SETTINGS_SaveChannel(uint8_t Channel, uint8_t VFO, const vfo_info_t *pVFO, uint8_t Mode)
 {
 	const uint16_t OffsetMR  = Channel * 16;
 	      uint16_t OffsetVFO = OffsetMR;
-	      uint8_t  State[8];
+	      uint8_t  State[16];
 
 	#ifdef ENABLE_NOAA
 		if (IS_NOAA_CHANNEL(Channel))
@@ -355,21 +411,22 @@ void SETTINGS_SaveChannel(uint8_t Channel, uint8_t VFO, const vfo_info_t *pVFO,
 
 	((uint32_t *)State)[0] = pVFO->freq_config_rx.frequency;
 	((uint32_t *)State)[1] = pVFO->tx_offset_freq;
-	EEPROM_WriteBuffer(OffsetVFO + 0, State);
-
-	State[0] =  pVFO->freq_config_rx.code;
-	State[1] =  pVFO->freq_config_tx.code;
-	State[2] = (pVFO->freq_config_tx.code_type << 4) | pVFO->freq_config_rx.code_type;
-	State[3] = ((pVFO->am_mode & 1u)           << 4) | pVFO->tx_offset_freq_dir;
-	State[4] =
+	State[ 8] =  pVFO->freq_config_rx.code;
+	State[ 9] =  pVFO->freq_config_tx.code;
+	State[10] = (pVFO->freq_config_tx.code_type << 4) | pVFO->freq_config_rx.code_type;
+	State[11] = ((pVFO->am_mode & 1u)           << 4) | pVFO->tx_offset_freq_dir;
+	State[12] =
 		  (pVFO->busy_channel_lock << 4)
 		| (pVFO->output_power      << 2)
 		| (pVFO->channel_bandwidth << 1)
 		| (pVFO->frequency_reverse  << 0);
-	State[5] = ((pVFO->dtmf_ptt_id_tx_mode & 7u) << 1) | ((pVFO->dtmf_decoding_enable & 1u) << 0);
-	State[6] =  pVFO->step_setting;
-	State[7] =  pVFO->scrambling_type;
-	EEPROM_WriteBuffer(OffsetVFO + 8, State);
+	State[13] = ((pVFO->dtmf_ptt_id_tx_mode & 7u) << 1) | ((pVFO->dtmf_decoding_enable & 1u) << 0);
+	State[14] =  pVFO->step_setting;
+	State[15] =  pVFO->scrambling_type;
+	SETTINGS_WriteBlocks(OffsetVFO, State, sizeof(State));   // the whole 16 byte record in the one page write
+
+	if (Channel <= USER_CHANNEL_LAST)
+		RADIO_InvalidateChannelIndex(Channel);
 
 	SETTINGS_UpdateChannel(Channel, pVFO, true);
 
@@ -379,16 +436,13 @@ void SETTINGS_SaveChannel(uint8_t Channel, uint8_t VFO, const vfo_info_t *pVFO,
 	#ifndef ENABLE_KEEP_MEM_NAME
 		// clear/reset the channel name
 		memset(&State, 0x00, sizeof(State));
-		EEPROM_WriteBuffer(0x0F50 + OffsetMR, State);
-		EEPROM_WriteBuffer(0x0F58 + OffsetMR, State);
+		SETTINGS_WriteBlocks(0x0F50 + OffsetMR, State, sizeof(State));
 	#else
 		if (Mode >= 3)
 		{	// save the channel name
-			memmove(State, pVFO->name + 0, 8);
-			EEPROM_WriteBuffer(0x0F50 + OffsetMR, State);
 			memset(State, 0x00, sizeof(State));
-			memmove(State, pVFO->name + 8, 2);
-			EEPROM_WriteBuffer(0x0F58 + OffsetMR, State);
+			memmove(State, pVFO->name, 10);
+			SETTINGS_WriteBlocks(0x0F50 + OffsetMR, State, sizeof(State));
 		}
 	#endif
 }
@@ -406,20 +460,25 @@ void SETTINGS_UpdateChannel(uint8_t Channel, const vfo_info_t *pVFO, bool keep)
 
 	Attributes &= (uint8_t)(~USER_CH_COMPAND);  // default to '0' = compander disabled
 
-	EEPROM_ReadBuffer(Offset, State, sizeof(State));
-
 	if (keep)
-	{
 		Attributes = (pVFO->scanlist_1_participation << 7) | (pVFO->scanlist_2_participation << 6) | (pVFO->compander << 4) | (pVFO->band << 0);
-		if (State[Channel & 7u] == Attributes)
-			return; // no change in the attributes
-	}
 
-	State[Channel & 7u] = Attributes;
+	EEPROM_ReadBuffer(Offset, State, sizeof(State));
 
-	EEPROM_WriteBuffer(Offset, State);
+	if (State[Channel & 7u] == Attributes)
+	{	// no change in the attributes
+		g_settings_writes_skipped++;
+		if (keep)
+			return;
+	}
+	else
+	{
+		State[Channel & 7u] = Attributes;
+		EEPROM_QueueWrite(Offset, State, sizeof(State));
+	}
 
 	g_user_channel_attributes[Channel] = Attributes;
+	RADIO_UpdateScanLists(Channel);
 
 //	#ifndef ENABLE_KEEP_MEM_NAME
 		if (Channel <= USER_CHANNEL_LAST)
@@ -430,8 +489,8 @@ void SETTINGS_UpdateChannel(uint8_t Channel, const vfo_info_t *pVFO, bool keep)
 			{	// clear/reset the channel name
 				//memset(&State, 0xFF, sizeof(State));
 				memset(&State, 0x00, sizeof(State));   // follow the QS way
-				EEPROM_WriteBuffer(0x0F50 + OffsetMR, State);
-				EEPROM_WriteBuffer(0x0F58 + OffsetMR, State);
+				SETTINGS_WriteBlocks(0x0F50 + OffsetMR, State, sizeof(State));
+				SETTINGS_WriteBlocks(0x0F58 + OffsetMR, State, sizeof(State));
 			}
 //			else
 //			{	// update the channel name
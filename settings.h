@@ -221,6 +221,7 @@ typedef struct {
 } eeprom_config_t;
 
 extern eeprom_config_t g_eeprom;
+extern uint32_t        g_settings_writes_skipped;   // EEPROM blocks a save found unchanged
 
 #ifdef ENABLE_FMRADIO
 	void SETTINGS_SaveFM(void);
@@ -0,0 +1,72 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+// SARADC model .. a healthy battery (about 7.6V) and no USB charge current
+
+#include "driver/adc.h"
+
+uint8_t ADC_GetChannelNumber(ADC_CH_MASK Mask)
+{
+	uint8_t i;
+	for (i = 0; i < 16; i++)
+		if (Mask & (1u << i))
+			return i;
+	return 0;
+}
+
+void ADC_Disable(void)
+{
+}
+
+void ADC_Enable(void)
+{
+}
+
+void ADC_SoftReset(void)
+{
+}
+
+uint32_t ADC_GetClockConfig(void)
+{
+	return 0;
+}
+
+void ADC_Configure(ADC_Config_t *pAdc)
+{
+	(void)pAdc;
+}
+
+void ADC_Start(void)
+{
+}
+
+bool ADC_CheckEndOfConversion(ADC_CH_MASK Mask)
+{
+	(void)Mask;
+	return true;
+}
+
+uint16_t ADC_GetValue(ADC_CH_MASK Mask)
+{
+	switch (Mask)
+	{
+		case ADC_CH4:   // battery voltage
+			return 2100;
+		default:        // ADC_CH9 USB current
+			return 0;
+	}
+}
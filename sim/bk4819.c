@@ -0,0 +1,80 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+// BK4819 register model
+//
+// writes land in a register file, reads give back what was written except
+// for the status/indicator registers, which report a quiet band with no
+// interrupts pending and no scan results
+
+#include "driver/bk4819.h"
+#include "sim/sim.h"
+
+static uint16_t bk4819_regs[128];
+
+// raw REG_67 RSSI reading (~ -120dBm)
+static const uint16_t sim_rssi = 80;
+
+uint16_t BK4819_ReadRegisterDirect(BK4819_REGISTER_t Register)
+{
+	g_sim_stats.bk4819_reads++;
+	SIM_BusDelay(SIM_BK4819_ACCESS_US);
+
+	switch (Register)
+	{
+		case BK4819_REG_0C:   // no interrupt request
+		case BK4819_REG_0B:
+		case BK4819_REG_63:
+		case BK4819_REG_64:
+		case BK4819_REG_65:
+		case BK4819_REG_6F:
+			return 0;
+
+		case BK4819_REG_0D:   // frequency scan busy
+		case BK4819_REG_68:   // CTCSS scan busy
+		case BK4819_REG_69:   // CDCSS scan busy
+			return 0x8000;
+
+		case BK4819_REG_67:
+			return sim_rssi;
+
+		default:
+			return bk4819_regs[Register & 0x7F];
+	}
+}
+
+void BK4819_WriteRegistersDirect(const BK4819_reg_val_t *pList, const unsigned int count)
+{
+	unsigned int i;
+	for (i = 0; i < count; i++)
+	{
+		g_sim_stats.bk4819_writes++;
+		bk4819_regs[pList[i].reg & 0x7F] = pList[i].val;
+	}
+
+	SIM_BusDelay(SIM_BK4819_WRITE_US * count);
+}
+
+void BK4819_WriteU8(uint8_t Data)
+{
+	(void)Data;
+}
+
+void BK4819_WriteU16(uint16_t Data)
+{
+	(void)Data;
+}
@@ -0,0 +1,42 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+// software version of the CRC block's CRC-16/CCITT (poly 0x1021, IV 0)
+
+#include "driver/crc.h"
+
+void CRC_Init(void)
+{
+}
+
+uint16_t CRC_Calculate(const void *pBuffer, uint16_t Size)
+{
+	const uint8_t *pData = (const uint8_t *)pBuffer;
+	uint16_t       Crc   = 0;
+	uint16_t       i;
+
+	for (i = 0; i < Size; i++)
+	{
+		unsigned int k;
+
+		Crc ^= (uint16_t)pData[i] << 8;
+		for (k = 0; k < 8; k++)
+			Crc = (Crc & 0x8000u) ? (uint16_t)((Crc << 1) ^ 0x1021u) : (uint16_t)(Crc << 1);
+	}
+
+	return Crc;
+}
@@ -0,0 +1,101 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+// BL24C64 model backed by an 8KB image file
+
+#include <stdio.h>
+#include <string.h>
+
+#include "driver/eeprom.h"
+#include "sim/sim.h"
+
+#define SIM_EEPROM_SIZE  0x2000u
+
+static uint8_t     eeprom[SIM_EEPROM_SIZE];
+static const char *eeprom_path;
+static uint64_t    eeprom_busy_until;
+
+void SIM_EEPROM_Load(const char *path)
+{
+	FILE *f;
+
+	memset(eeprom, 0xFF, sizeof(eeprom));   // blank chip
+
+	eeprom_path = path;
+	if (path == NULL)
+		return;
+
+	f = fopen(path, "rb");
+	if (f == NULL)
+		return;   // new image, created on exit
+	if (fread(eeprom, 1, sizeof(eeprom), f) != sizeof(eeprom))
+		fprintf(stderr, "%s: short EEPROM image, rest left blank\n", path);
+	fclose(f);
+}
+
+void SIM_EEPROM_Save(void)
+{
+	FILE *f;
+
+	if (eeprom_path == NULL)
+		return;
+
+	f = fopen(eeprom_path, "wb");
+	if (f == NULL)
+	{
+		perror(eeprom_path);
+		return;
+	}
+	fwrite(eeprom, 1, sizeof(eeprom), f);
+	fclose(f);
+}
+
+void EEPROM_ReadBufferDirect(uint16_t Address, void *pBuffer, unsigned int Size)
+{
+	uint8_t *pData = (uint8_t *)pBuffer;
+	unsigned int i;
+
+	for (i = 0; i < Size; i++)
+		pData[i] = eeprom[(Address + i) % SIM_EEPROM_SIZE];
+
+	g_sim_stats.eeprom_reads++;
+	g_sim_stats.eeprom_read_bytes += Size;
+	SIM_BusDelay((3u + Size) * SIM_EEPROM_BYTE_US);
+}
+
+// one page write .. the chip then stays busy (NACKing its address) for
+// the program time
+void EEPROM_WritePageDirect(uint16_t Address, const void *pBuffer, unsigned int Size)
+{
+	const uint8_t *pData = (const uint8_t *)pBuffer;
+	unsigned int   i;
+
+	for (i = 0; i < Size; i++)
+		eeprom[(Address & ~(EEPROM_PAGE_SIZE - 1u)) + ((Address + i) % EEPROM_PAGE_SIZE)] = pData[i];
+
+	g_sim_stats.eeprom_writes++;
+	g_sim_stats.eeprom_write_bytes += Size;
+	SIM_BusDelay((3u + Size) * SIM_EEPROM_BYTE_US);
+
+	eeprom_busy_until = SIM_MonotonicUs() + SIM_EEPROM_WRITE_US;
+}
+
+bool EEPROM_IsBusyDirect(void)
+{
+	SIM_BusDelay(2u * SIM_EEPROM_BYTE_US);
+	return (SIM_MonotonicUs() < eeprom_busy_until) ? true : false;
+}
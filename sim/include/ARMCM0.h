@@ -0,0 +1,53 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// host simulator stand-in for the CMSIS ARMCM0 device header
+//
+// the host-sim build puts sim/include ahead of CMSIS on the include path,
+// so the firmware's "ARMCM0.h" includes land here instead of on the real
+// core header (which is full of Cortex-M0 inline asm)
+
+#ifndef SIM_ARMCM0_H
+#define SIM_ARMCM0_H
+
+#include <stdint.h>
+
+typedef int IRQn_Type;
+
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t LOAD;
+	volatile uint32_t VAL;
+	volatile uint32_t CALIB;
+} SysTick_Type;
+
+extern SysTick_Type sim_systick;
+
+#define SysTick     (&sim_systick)
+
+void     NVIC_EnableIRQ(IRQn_Type IRQn);
+void     NVIC_DisableIRQ(IRQn_Type IRQn);
+void     NVIC_SystemReset(void);
+uint32_t SysTick_Config(uint32_t ticks);
+
+void     __disable_irq(void);
+void     __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void     __set_PRIMASK(uint32_t priMask);
+
+#define  __NOP()    do {} while (0)
+
+#endif
@@ -0,0 +1,223 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+// scripted key feed
+//
+// one event per line, '#' starts a comment
+//
+//   <tick> <key> [hold]   press a key for 'hold' ticks (default 10)
+//   <tick> shot <file>    save the screen as a PBM
+//   <tick> quit           end the run
+//
+// <tick> is absolute, or relative to the previous event when it starts
+// with '+'.  Keys are 0-9 MENU UP DOWN EXIT STAR F PTT SIDE1 SIDE2
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "bsp/dp32g030/gpio.h"
+#include "driver/gpio.h"
+#include "driver/keyboard.h"
+#include "misc.h"
+#include "sim/sim.h"
+
+enum sim_key_event_type_e {
+	SIM_KEY_PRESS = 0,
+	SIM_KEY_SHOT,
+	SIM_KEY_QUIT
+};
+typedef enum sim_key_event_type_e sim_key_event_type_t;
+
+typedef struct {
+	uint32_t             tick;
+	sim_key_event_type_t type;
+	key_code_t           key;
+	uint32_t             hold;
+	char                 path[64];
+} sim_key_event_t;
+
+#define SIM_MAX_KEY_EVENTS  256
+#define SIM_KEY_DRAIN_TICKS 200   // keep running this long after the last event
+
+static const struct {
+	const char *name;
+	key_code_t  key;
+} key_names[] = {
+	{"0", KEY_0}, {"1", KEY_1}, {"2", KEY_2}, {"3", KEY_3}, {"4", KEY_4},
+	{"5", KEY_5}, {"6", KEY_6}, {"7", KEY_7}, {"8", KEY_8}, {"9", KEY_9},
+	{"MENU",  KEY_MENU},  {"UP",    KEY_UP},    {"DOWN", KEY_DOWN},
+	{"EXIT",  KEY_EXIT},  {"STAR",  KEY_STAR},  {"F",    KEY_F},
+	{"PTT",   KEY_PTT},   {"SIDE1", KEY_SIDE1}, {"SIDE2", KEY_SIDE2}
+};
+
+static sim_key_event_t   key_events[SIM_MAX_KEY_EVENTS];
+static unsigned int      key_event_count;
+static volatile unsigned key_event_next;
+
+static volatile key_code_t key_down = KEY_INVALID;
+static volatile uint32_t   key_release_tick;
+static volatile int        key_shot = -1;
+
+void SIM_KEYBOARD_Load(const char *path)
+{
+	char     line[128];
+	uint32_t tick = 0;
+	FILE    *f;
+
+	if (path == NULL)
+		return;
+
+	f = fopen(path, "r");
+	if (f == NULL)
+	{
+		perror(path);
+		return;
+	}
+
+	while (fgets(line, sizeof(line), f) != NULL && key_event_count < SIM_MAX_KEY_EVENTS)
+	{
+		sim_key_event_t *e = &key_events[key_event_count];
+		char             when[16];
+		char             what[16];
+		char             arg[64];
+		unsigned int     i;
+		int              n;
+
+		*strchrnul(line, '#') = 0;
+		n = sscanf(line, "%15s %15s %63s", when, what, arg);
+		if (n < 2)
+			continue;
+
+		tick = (when[0] == '+') ? tick + strtoul(when + 1, NULL, 0) : strtoul(when, NULL, 0);
+
+		memset(e, 0, sizeof(*e));
+		e->tick = tick;
+		e->hold = 10;
+
+		if (strcasecmp(what, "quit") == 0)
+			e->type = SIM_KEY_QUIT;
+		else
+		if (strcasecmp(what, "shot") == 0 && n == 3)
+		{
+			e->type = SIM_KEY_SHOT;
+			snprintf(e->path, sizeof(e->path), "%s", arg);
+		}
+		else
+		{
+			for (i = 0; i < ARRAY_SIZE(key_names); i++)
+				if (strcasecmp(what, key_names[i].name) == 0)
+					break;
+			if (i >= ARRAY_SIZE(key_names))
+			{
+				fprintf(stderr, "%s: unknown key '%s'\n", path, what);
+				continue;
+			}
+			e->type = SIM_KEY_PRESS;
+			e->key  = key_names[i].key;
+			if (n == 3)
+				e->hold = strtoul(arg, NULL, 0);
+		}
+
+		key_event_count++;
+	}
+
+	fclose(f);
+}
+
+void SIM_KEYBOARD_Tick(void)
+{	// signal context
+	const uint32_t now = SIM_Now();
+
+	if (key_down != KEY_INVALID && now >= key_release_tick)
+	{
+		if (key_down == KEY_PTT)
+			GPIOC->DATA |= 1u << GPIOC_PIN_PTT;
+		key_down = KEY_INVALID;
+	}
+
+	while (key_event_next < key_event_count && key_shot < 0)
+	{
+		const sim_key_event_t *e = &key_events[key_event_next];
+
+		if (e->tick > now)
+			break;
+		if (e->type == SIM_KEY_PRESS && key_down != KEY_INVALID)
+			break;   // still holding the previous key
+
+		key_event_next++;
+
+		switch (e->type)
+		{
+			case SIM_KEY_PRESS:
+				key_down         = e->key;
+				key_release_tick = now + e->hold;
+				if (e->key == KEY_PTT)
+					GPIOC->DATA &= ~(1u << GPIOC_PIN_PTT);
+				break;
+
+			case SIM_KEY_SHOT:
+				key_shot = (int)(e - key_events);
+				break;
+
+			case SIM_KEY_QUIT:
+				g_sim_quit = true;
+				break;
+		}
+	}
+}
+
+void SIM_KEYBOARD_Service(void)
+{	// main context
+	const int shot = key_shot;
+
+	if (shot >= 0)
+	{
+		SIM_LCD_Save(key_events[shot].path);
+		key_shot = -1;
+	}
+}
+
+bool SIM_KEYBOARD_Done(void)
+{
+	if (key_event_count == 0 || key_event_next < key_event_count || key_down != KEY_INVALID)
+		return false;
+	return SIM_Now() >= key_events[key_event_count - 1].tick + SIM_KEY_DRAIN_TICKS;
+}
+
+// the matrix as the driver sees it .. PTT is a GPIO line, not part of it
+uint8_t KEYBOARD_ReadRowDirect(const unsigned int row)
+{
+	const key_code_t key  = key_down;
+	uint8_t          keys = 0;
+	unsigned int     i;
+
+	for (i = 0; i < KEYBOARD_ROW_KEYS; i++)
+		if (key != KEY_INVALID && KEYBOARD_RowKey(row, i) == key)
+			keys |= 1u << i;
+
+	return keys;
+}
+
+void KEYBOARD_ReleaseDirect(void)
+{
+	g_sim_stats.key_polls++;
+
+	SIM_Service();
+}
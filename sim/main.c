@@ -0,0 +1,267 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+// host-native simulator for the firmware
+//
+// the real app/, ui/, radio.c, settings.c etc are built for the host and run
+// against the replacement drivers in sim/ .. the peripheral address space the
+// firmware pokes directly is backed by plain RAM, the 10ms systick interrupt
+// is a SIGALRM, and the bus level drivers (BK4819, EEPROM, LCD, keypad, UART)
+// are models that count every transaction
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "ARMCM0.h"
+#include "bsp/dp32g030/gpio.h"
+#include "driver/bk4819.h"
+#include "driver/eeprom.h"
+#include "driver/gpio.h"
+#include "init.h"
+#include "scheduler.h"
+#include "settings.h"
+#include "sim/sim.h"
+
+// DP32G030 peripherals live between SYSCON and AES
+#define SIM_PERIPH_BASE   0x40000000UL
+#define SIM_PERIPH_SIZE   0x000C0000UL
+
+sim_stats_t   g_sim_stats;
+volatile bool g_sim_quit;
+SysTick_Type  sim_systick;
+
+static const char       *sim_screen_path;
+static uint32_t          sim_tick_limit;
+static volatile uint32_t sim_ticks;
+static sigset_t          sim_tick_sigset;
+
+void Main(void);
+
+extern volatile bool g_next_time_slice;
+
+static void SIM_Usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  -e FILE  8KB EEPROM image (loaded at start, written back on exit)\n"
+		"  -k FILE  scripted key feed\n"
+		"  -s FILE  write the final screen to FILE (PBM)\n"
+		"  -t N     stop after N 10ms ticks\n"
+		"  -u FILE  write UART TX bytes to FILE\n"
+		"  -U FILE  feed the bytes in FILE to the UART RX DMA buffer\n",
+		name);
+}
+
+static void SIM_TickHandler(int sig)
+{
+	(void)sig;
+
+	sim_ticks++;
+	g_sim_stats.ticks++;
+
+	// the main loop never got round to the previous slice
+	if (g_next_time_slice)
+		g_sim_stats.slice_overruns++;
+
+	SIM_KEYBOARD_Tick();
+	SIM_UART_Tick();
+
+	SystickHandler();
+
+	if (sim_tick_limit > 0 && sim_ticks >= sim_tick_limit)
+		g_sim_quit = true;
+	if (sim_tick_limit == 0 && SIM_KEYBOARD_Done())
+		g_sim_quit = true;
+}
+
+static void SIM_PrintStats(void)
+{
+	const sim_stats_t *s = &g_sim_stats;
+	const uint64_t bk4819_us = ((uint64_t)s->bk4819_reads * SIM_BK4819_ACCESS_US) + ((uint64_t)s->bk4819_writes * SIM_BK4819_WRITE_US);
+	const uint64_t eeprom_us = (uint64_t)(s->eeprom_read_bytes + s->eeprom_write_bytes) * SIM_EEPROM_BYTE_US
+	                         + (uint64_t)s->eeprom_writes * SIM_EEPROM_WRITE_US;
+	const uint64_t lcd_us    = (uint64_t)s->lcd_bytes * SIM_SPI_BYTE_US;
+
+	fprintf(stderr, "ticks          %10u\n", s->ticks);
+	fprintf(stderr, "slice overruns %10u\n", s->slice_overruns);
+	fprintf(stderr, "bk4819 reads   %10u\n", s->bk4819_reads);
+	fprintf(stderr, "bk4819 writes  %10u   ~%llu ms on target\n", s->bk4819_writes, (unsigned long long)(bk4819_us / 1000));
+	fprintf(stderr, "bk4819 saved   %10u   (register shadow)\n", g_bk4819_bus_cycles_saved);
+	fprintf(stderr, "eeprom reads   %10u   %u bytes\n", s->eeprom_reads, s->eeprom_read_bytes);
+	fprintf(stderr, "eeprom writes  %10u   %u bytes   ~%llu ms on target\n", s->eeprom_writes, s->eeprom_write_bytes, (unsigned long long)(eeprom_us / 1000));
+	fprintf(stderr, "eeprom skipped %10u   (unchanged settings blocks)\n", g_settings_writes_skipped);
+	fprintf(stderr, "lcd blits      %10u   %u status   %u bytes   ~%llu ms on target\n", s->lcd_full_blits, s->lcd_status_blits, s->lcd_bytes, (unsigned long long)(lcd_us / 1000));
+	fprintf(stderr, "key polls      %10u\n", s->key_polls);
+	fprintf(stderr, "uart           %10u tx   %u rx\n", s->uart_tx_bytes, s->uart_rx_bytes);
+	fprintf(stderr, "delays         %10llu ms\n", (unsigned long long)(s->delay_us / 1000));
+	fprintf(stderr, "idle           %10llu ms   %u%%\n", (unsigned long long)(s->idle_us / 1000), (s->ticks > 0) ? (unsigned int)(s->idle_us / (s->ticks * 100ull)) : 0u);
+}
+
+static void SIM_Exit(const int code)
+{
+	struct itimerval timer;
+
+	memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_REAL, &timer, NULL);
+
+	EEPROM_Flush();   // as on a power down
+	SIM_EEPROM_Save();
+	if (sim_screen_path != NULL)
+		SIM_LCD_Save(sim_screen_path);
+	SIM_UART_Close();
+	SIM_PrintStats();
+
+	exit(code);
+}
+
+uint32_t SIM_Now(void)
+{
+	return sim_ticks;
+}
+
+void SIM_Service(void)
+{
+	if (g_sim_quit)
+		SIM_Exit(0);
+	SIM_KEYBOARD_Service();
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+	(void)IRQn;
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+	(void)IRQn;
+}
+
+void NVIC_SystemReset(void)
+{
+	fprintf(stderr, "NVIC_SystemReset() at tick %u\n", sim_ticks);
+	SIM_Exit(0);
+}
+
+uint32_t SysTick_Config(uint32_t ticks)
+{
+	sim_systick.LOAD = ticks - 1;
+	sim_systick.VAL  = 0;
+	sim_systick.CTRL = 7;
+	return 0;
+}
+
+// the firmware runs on the host's stack, there's nothing painted to measure
+uint32_t STACK_GetHighWater(void)
+{
+	return 0;
+}
+
+uint32_t STACK_GetSize(void)
+{
+	return 0;
+}
+
+void __disable_irq(void)
+{
+	sigprocmask(SIG_BLOCK, &sim_tick_sigset, NULL);
+}
+
+void __enable_irq(void)
+{
+	sigprocmask(SIG_UNBLOCK, &sim_tick_sigset, NULL);
+}
+
+// 1 while the tick signal's blocked, as PRIMASK is while the interrupts are off
+uint32_t __get_PRIMASK(void)
+{
+	sigset_t blocked;
+	sigprocmask(SIG_BLOCK, NULL, &blocked);
+	return sigismember(&blocked, SIGALRM) ? 1 : 0;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+	sigprocmask((priMask & 1u) ? SIG_BLOCK : SIG_UNBLOCK, &sim_tick_sigset, NULL);
+}
+
+int main(int argc, char *argv[])
+{
+	const char      *eeprom_path   = NULL;
+	const char      *keys_path     = NULL;
+	const char      *uart_in_path  = NULL;
+	const char      *uart_out_path = NULL;
+	struct sigaction action;
+	struct itimerval timer;
+	void            *periph;
+	int              opt;
+
+	while ((opt = getopt(argc, argv, "e:k:s:t:u:U:h")) != -1)
+	{
+		switch (opt)
+		{
+			case 'e': eeprom_path     = optarg;                        break;
+			case 'k': keys_path       = optarg;                        break;
+			case 's': sim_screen_path = optarg;                        break;
+			case 't': sim_tick_limit  = strtoul(optarg, NULL, 0);      break;
+			case 'u': uart_out_path   = optarg;                        break;
+			case 'U': uart_in_path    = optarg;                        break;
+			default:
+				SIM_Usage(argv[0]);
+				return (opt == 'h') ? 0 : 1;
+		}
+	}
+
+	// back the peripheral registers the firmware accesses directly with RAM
+	periph = mmap((void *)SIM_PERIPH_BASE, SIM_PERIPH_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (periph != (void *)SIM_PERIPH_BASE)
+	{
+		fprintf(stderr, "unable to map the peripheral space at 0x%08lX: %s\n", SIM_PERIPH_BASE, strerror(errno));
+		return 1;
+	}
+
+	// PTT is active low
+	GPIOC->DATA |= 1u << GPIOC_PIN_PTT;
+
+	SIM_EEPROM_Load(eeprom_path);
+	SIM_KEYBOARD_Load(keys_path);
+	SIM_UART_Open(uart_in_path, uart_out_path);
+
+	sigemptyset(&sim_tick_sigset);
+	sigaddset(&sim_tick_sigset, SIGALRM);
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = SIM_TickHandler;
+	action.sa_flags   = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGALRM, &action, NULL);
+
+	memset(&timer, 0, sizeof(timer));
+	timer.it_interval.tv_usec = 10000;
+	timer.it_value.tv_usec    = 10000;
+	setitimer(ITIMER_REAL, &timer, NULL);
+
+	Main();
+
+	SIM_Exit(0);
+	return 0;
+}
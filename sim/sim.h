@@ -0,0 +1,84 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef SIM_SIM_H
+#define SIM_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// rough on-target cost of each bus operation, used to turn the transaction
+// counts into an estimate of how long the real radio spends on the bus
+#define SIM_BK4819_ACCESS_US     80u   // one 3-wire register read
+#define SIM_BK4819_WRITE_US      30u   // one 3-wire register write
+#define SIM_EEPROM_BYTE_US       30u   // one bit-banged I2C byte
+#define SIM_EEPROM_WRITE_US    4000u   // page program time, ACK polled
+#define SIM_SPI_BYTE_US           2u   // one ST7565 byte through SPI0
+
+typedef struct {
+	uint32_t ticks;                // 10ms systick interrupts delivered
+	uint32_t slice_overruns;       // ticks where the previous 10ms slice was still pending
+
+	uint32_t bk4819_reads;
+	uint32_t bk4819_writes;
+
+	uint32_t eeprom_reads;
+	uint32_t eeprom_read_bytes;
+	uint32_t eeprom_writes;
+	uint32_t eeprom_write_bytes;
+
+	uint32_t lcd_full_blits;
+	uint32_t lcd_status_blits;
+	uint32_t lcd_bytes;
+
+	uint32_t key_polls;
+	uint32_t uart_tx_bytes;
+	uint32_t uart_rx_bytes;
+
+	uint64_t delay_us;             // time spent in SYSTICK_DelayUs()
+	uint64_t idle_us;              // time spent in SYSTICK_Sleep()
+} sim_stats_t;
+
+extern sim_stats_t   g_sim_stats;
+extern volatile bool g_sim_quit;
+
+// sim/main.c
+uint32_t SIM_Now(void);                    // 10ms ticks since start
+void     SIM_Service(void);                // quit/screenshot handling, main context only
+
+// sim/systick.c
+uint64_t SIM_MonotonicUs(void);
+void     SIM_BusDelay(const uint32_t us);
+
+// sim/eeprom.c
+void     SIM_EEPROM_Load(const char *path);
+void     SIM_EEPROM_Save(void);
+
+// sim/st7565.c
+void     SIM_LCD_Save(const char *path);
+
+// sim/keyboard.c
+void     SIM_KEYBOARD_Load(const char *path);
+void     SIM_KEYBOARD_Tick(void);
+void     SIM_KEYBOARD_Service(void);
+bool     SIM_KEYBOARD_Done(void);
+
+// sim/uart.c
+void     SIM_UART_Open(const char *in_path, const char *out_path);
+void     SIM_UART_Tick(void);
+void     SIM_UART_Close(void);
+
+#endif
@@ -0,0 +1,170 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+// ST7565 model .. keeps the 128x64 panel contents and dumps them as a PBM
+
+#include <stdio.h>
+#include <string.h>
+
+#include "driver/st7565.h"
+#ifdef ENABLE_BUS_TRACE
+	#include "helper/trace.h"
+#endif
+#include "misc.h"
+#include "sim/sim.h"
+
+uint8_t g_status_line[128];
+uint8_t g_frame_buffer[7][128];
+uint8_t contrast = 31;  // 0 ~ 63
+
+static uint8_t lcd[8][128];
+
+void SIM_LCD_Save(const char *path)
+{
+	FILE *f = fopen(path, "w");
+	unsigned int x;
+	unsigned int y;
+
+	if (f == NULL)
+	{
+		perror(path);
+		return;
+	}
+
+	fprintf(f, "P1\n%u %u\n", LCD_WIDTH, LCD_HEIGHT);
+	for (y = 0; y < LCD_HEIGHT; y++)
+	{
+		for (x = 0; x < LCD_WIDTH; x++)
+			fputc(((lcd[y / 8][x] >> (y % 8)) & 1u) ? '1' : '0', f);
+		fputc('\n', f);
+	}
+	fclose(f);
+}
+
+void ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const unsigned int Size, const uint8_t *pBitmap)
+{
+	unsigned int i;
+
+	for (i = 0; i < Size && (Column + i) < ARRAY_SIZE(lcd[0]); i++)
+		lcd[Line % ARRAY_SIZE(lcd)][Column + i] = (pBitmap != NULL) ? pBitmap[i] : 0;
+
+	g_sim_stats.lcd_bytes += Size;
+}
+
+// bytes the driver sends for one page .. the changed column span only,
+// unless it's due a full refresh
+static void SIM_LCD_Line(const unsigned int Line, const uint8_t *pData, const bool full)
+{
+	unsigned int first = 0;
+	unsigned int last  = ARRAY_SIZE(lcd[0]);
+
+	if (!full)
+	{
+		while (first < last && pData[first] == lcd[Line][first])
+			first++;
+		while (last > first && pData[last - 1] == lcd[Line][last - 1])
+			last--;
+	}
+
+	memcpy(lcd[Line], pData, ARRAY_SIZE(lcd[0]));
+	g_sim_stats.lcd_bytes += last - first;
+}
+
+void ST7565_BlitFullScreen(void)
+{
+	static unsigned int blit_count;
+	unsigned int        Line;
+	bool                full = false;
+
+	if (++blit_count >= ST7565_FULL_REFRESH_BLITS)
+	{
+		blit_count = 0;
+		full       = true;
+	}
+
+	for (Line = 0; Line < ARRAY_SIZE(g_frame_buffer); Line++)
+		SIM_LCD_Line(Line + 1, g_frame_buffer[Line], full);
+
+	g_sim_stats.lcd_full_blits++;
+
+	#ifdef ENABLE_BUS_TRACE
+		TRACE_Log(TRACE_LCD_BLIT, 1, ARRAY_SIZE(g_frame_buffer));
+	#endif
+}
+
+// the model has the frame on the panel the moment it's blitted
+void ST7565_Service(void)
+{
+}
+
+bool ST7565_IsBlitting(void)
+{
+	return false;
+}
+
+void ST7565_WaitForBlit(void)
+{
+}
+
+void ST7565_BlitStatusLine(void)
+{
+	SIM_LCD_Line(0, g_status_line, false);
+
+	g_sim_stats.lcd_status_blits++;
+
+	#ifdef ENABLE_BUS_TRACE
+		TRACE_Log(TRACE_LCD_BLIT, 0, 1);
+	#endif
+}
+
+void ST7565_FillScreen(const uint8_t Value)
+{
+	memset(lcd, Value, sizeof(lcd));
+
+	g_sim_stats.lcd_bytes += 8 * 132;
+}
+
+void ST7565_Init(const bool full)
+{
+	if (full)
+		ST7565_FillScreen(0x00);
+}
+
+void ST7565_HardwareReset(void)
+{
+}
+
+void ST7565_SelectColumnAndLine(const uint8_t Column, const uint8_t Line)
+{
+	(void)Column;
+	(void)Line;
+}
+
+void ST7565_WriteByte(const uint8_t Value)
+{
+	(void)Value;
+}
+
+void ST7565_SetContrast(const uint8_t value)
+{
+	contrast = (value <= 63) ? value : 63;
+}
+
+uint8_t ST7565_GetContrast(void)
+{
+	return contrast;
+}
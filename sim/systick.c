@@ -0,0 +1,74 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <signal.h>
+#include <time.h>
+
+#include "ARMCM0.h"
+#include "driver/systick.h"
+#include "sim/sim.h"
+
+uint64_t SIM_MonotonicUs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000u) + ((uint64_t)ts.tv_nsec / 1000u);
+}
+
+void SIM_BusDelay(const uint32_t us)
+{	// burn the time the real bus transfer would have taken
+	const uint64_t end = SIM_MonotonicUs() + us;
+	while (SIM_MonotonicUs() < end) {}
+}
+
+void SYSTICK_Init(void)
+{
+	SysTick_Config(SYSTICK_CLOCKS_PER_TICK);
+}
+
+uint32_t SYSTICK_Sleep(void)
+{	// the tick signal is blocked (__disable_irq), wait for it to arrive
+	const uint64_t start = SIM_MonotonicUs();
+	sigset_t       none;
+	uint64_t       us;
+
+	sigemptyset(&none);
+	sigsuspend(&none);
+
+	us = SIM_MonotonicUs() - start;
+	g_sim_stats.idle_us += us;
+
+	SIM_Service();
+
+	return (uint32_t)(us * (SYSTICK_CLOCKS_PER_TICK / 10000u));
+}
+
+uint32_t SYSTICK_GetClocks(void)
+{	// no systick counter to read, host time at 48 clocks per us .. the spectrum
+	// busy waits on this, so it's somewhere to act on a quit or a screen shot too
+	SIM_Service();
+	return (uint32_t)(SIM_MonotonicUs() * (SYSTICK_CLOCKS_PER_TICK / 10000u));
+}
+
+void SYSTICK_DelayUs(uint32_t Delay)
+{
+	g_sim_stats.delay_us += Delay;
+
+	SIM_BusDelay(Delay);
+
+	SIM_Service();
+}
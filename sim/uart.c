@@ -0,0 +1,137 @@
+/* Copyright 2023 OneOfEleven
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+// UART1 model
+//
+// TX bytes go to a file, RX bytes are fed into UART_DMA_Buffer a few per
+// tick and the DMA channel's write index is advanced, just like the real
+// UART1 -> DMA CH0 circular transfer
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bsp/dp32g030/dma.h"
+#include "driver/uart.h"
+#include "external/printf/printf.h"
+#include "sim/sim.h"
+
+#define SIM_UART_RX_BYTES_PER_TICK  38   // ~38400 baud
+
+static bool     UART_IsLogEnabled;
+uint8_t         UART_DMA_Buffer[256];
+
+static FILE    *uart_out;
+static uint8_t *uart_in;
+static size_t   uart_in_size;
+static size_t   uart_in_pos;
+
+void SIM_UART_Open(const char *in_path, const char *out_path)
+{
+	if (out_path != NULL)
+	{
+		uart_out = fopen(out_path, "wb");
+		if (uart_out == NULL)
+			perror(out_path);
+	}
+
+	if (in_path != NULL)
+	{
+		FILE *f = fopen(in_path, "rb");
+		if (f == NULL)
+		{
+			perror(in_path);
+			return;
+		}
+		fseek(f, 0, SEEK_END);
+		uart_in_size = ftell(f);
+		fseek(f, 0, SEEK_SET);
+		uart_in = malloc(uart_in_size);
+		if (uart_in == NULL || fread(uart_in, 1, uart_in_size, f) != uart_in_size)
+			uart_in_size = 0;
+		fclose(f);
+	}
+}
+
+void SIM_UART_Tick(void)
+{	// signal context
+	unsigned int index = DMA_CH0->ST & 0xFFFu;
+	unsigned int i;
+
+	for (i = 0; i < SIM_UART_RX_BYTES_PER_TICK && uart_in_pos < uart_in_size; i++)
+	{
+		UART_DMA_Buffer[index] = uart_in[uart_in_pos++];
+		index = (index + 1) % sizeof(UART_DMA_Buffer);
+		g_sim_stats.uart_rx_bytes++;
+	}
+
+	DMA_CH0->ST = (DMA_CH0->ST & ~0xFFFu) | index;
+}
+
+void SIM_UART_Close(void)
+{
+	if (uart_out != NULL)
+		fclose(uart_out);
+	uart_out = NULL;
+}
+
+void UART_Init(void)
+{
+	DMA_CH0->ST = 0;
+}
+
+void UART_Send(const void *pBuffer, uint32_t Size)
+{
+	if (uart_out != NULL)
+		fwrite(pBuffer, 1, Size, uart_out);
+	g_sim_stats.uart_tx_bytes += Size;
+}
+
+void UART_SendText(const void *str)
+{
+	if (str)
+		UART_Send(str, strlen(str));
+}
+
+void UART_LogSend(const void *pBuffer, uint32_t Size)
+{
+	if (UART_IsLogEnabled)
+		UART_Send(pBuffer, Size);
+}
+
+void UART_LogSendText(const void *str)
+{
+	if (UART_IsLogEnabled && str)
+		UART_Send(str, strlen(str));
+}
+
+#if defined(ENABLE_UART) && defined(ENABLE_UART_DEBUG)
+	void UART_printf(const char *str, ...)
+	{
+		char text[256];
+		int  len;
+
+		va_list va;
+		va_start(va, str);
+			len = vsnprintf(text, sizeof(text), str, va);
+		va_end(va);
+
+		UART_Send(text, len);
+	}
+#endif
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+
+# reads the bus trace ring out of a radio built with ENABLE_BUS_TRACE and
+# prints it as a timeline, followed by the busiest registers/addresses
+#
+#   trace-dump.py /dev/ttyUSB0            talk to the radio (needs pyserial)
+#   trace-dump.py --replies capture.bin   decode replies captured elsewhere,
+#                                         eg. by the host simulator's -u option
+
+import struct
+import sys
+
+from collections import Counter
+
+OBFUSCATION = [0x16, 0x6C, 0x14, 0xE6, 0x2E, 0x91, 0x0D, 0x40, 0x21, 0x35, 0xD5, 0x40, 0x13, 0x03, 0xE9, 0x80]
+
+TYPES = ['bk4819 rd', 'bk4819 rd shadow', 'bk4819 wr', 'bk4819 wr skipped', 'eeprom rd', 'eeprom wr', 'lcd blit']
+
+TRACE_PAUSE = 1 << 0
+TRACE_CLEAR = 1 << 1
+
+CLOCKS_PER_US = 48
+ENTRY         = struct.Struct('<IHHB3x')
+
+def crc16(data):
+    crc = 0
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+def obfuscate(data):
+    return bytes(b ^ OBFUSCATION[i % 16] for i, b in enumerate(data))
+
+def packet(cmd_id, payload):
+    body = struct.pack('<HH', cmd_id, len(payload)) + payload
+    body = obfuscate(body + struct.pack('<H', crc16(body)))
+    return b'\xAB\xCD' + struct.pack('<H', len(body) - 2) + body + b'\xDC\xBA'
+
+def replies(data):
+    i = 0
+    while True:
+        i = data.find(b'\xAB\xCD', i)
+        if i < 0 or i + 4 > len(data):
+            return
+        size = struct.unpack('<H', data[i + 2:i + 4])[0]
+        body = obfuscate(data[i + 4:i + 4 + size])
+        i += 4 + size
+        if len(body) >= 4 and struct.unpack('<H', body[:2])[0] == 0x0534:
+            yield body[4:]
+
+def parse(reply):
+    total, index, count, size = struct.unpack('<IHBB', reply[:8])
+    entries = [ENTRY.unpack_from(reply, 8 + (n * ENTRY.size)) for n in range(count)]
+    return total, index, size, entries
+
+def read_radio(port):
+    import serial
+    uart  = serial.Serial(port, 38400, timeout=1)
+    trace = []
+    index = 0
+    while True:
+        # keep the ring paused till the last chunk's been read
+        uart.write(packet(0x0533, struct.pack('<HBx', index, TRACE_PAUSE)))
+        chunk = [parse(r) for r in replies(uart.read(4 + 4 + 8 + (16 * ENTRY.size) + 4))]
+        if not chunk:
+            sys.exit('no reply from the radio')
+        total, _, size, entries = chunk[0]
+        trace += entries
+        index += len(entries)
+        if not entries or index >= min(total, size):
+            break
+    uart.write(packet(0x0533, struct.pack('<HBx', 0, TRACE_CLEAR)))
+    return trace
+
+def read_file(path):
+    trace = {}
+    for reply in replies(open(path, 'rb').read()):
+        _, index, _, entries = parse(reply)
+        for n, entry in enumerate(entries):
+            trace[index + n] = entry
+    return [trace[n] for n in sorted(trace)]
+
+def show(trace):
+    if not trace:
+        print('trace is empty')
+        return
+
+    start = prev = trace[0][0]
+    for time, addr, value, kind in trace:
+        print('%10.1f ms  +%8u us  %-17s  %04X  %04X' % (
+            ((time - start) & 0xFFFFFFFF) / (CLOCKS_PER_US * 1000.0),
+            ((time - prev) & 0xFFFFFFFF) // CLOCKS_PER_US,
+            TYPES[kind] if kind < len(TYPES) else str(kind), addr, value))
+        prev = time
+
+    print()
+    print('busiest')
+    for (kind, addr), count in Counter((kind, addr) for _, addr, _, kind in trace).most_common(16):
+        print('%6u  %-17s  %04X' % (count, TYPES[kind] if kind < len(TYPES) else str(kind), addr))
+
+if __name__ == '__main__':
+    if len(sys.argv) == 3 and sys.argv[1] == '--replies':
+        show(read_file(sys.argv[2]))
+    elif len(sys.argv) == 2:
+        show(read_radio(sys.argv[1]))
+    else:
+        sys.exit('usage: %s PORT | --replies FILE' % sys.argv[0])
@@ -152,6 +152,41 @@ void UI_PrintStringSmallBuffer(const char *pString, uint8_t *buffer)
 	}
 }
 
+#ifdef ENABLE_SPECTRUM
+	// 3x5 font at any pixel position, 'fill' false draws it in black on a set background
+	void UI_PrintStringSmallest(const char *pString, uint8_t x, uint8_t y, bool statusbar, bool fill)
+	{
+		uint8_t     *pBuffer = statusbar ? g_status_line : &g_frame_buffer[0][0];
+		const size_t lines   = statusbar ? 1 : ARRAY_SIZE(g_frame_buffer);
+
+		for (; *pString != 0; pString++, x += 4)
+		{
+			const unsigned int index = (unsigned int)*pString - 32;
+			unsigned int       i;
+
+			if (*pString < 32 || index >= ARRAY_SIZE(g_font3x5))
+				continue;
+
+			for (i = 0; i < ARRAY_SIZE(g_font3x5[0]) && (x + i) < 128; i++)
+			{
+				uint8_t      pixels = g_font3x5[index][i];
+				unsigned int j;
+
+				for (j = 0; j < 6 && (y + j) < (lines * 8); j++, pixels >>= 1)
+				{
+					uint8_t *p = &pBuffer[(((y + j) >> 3) * 128) + x + i];
+					if ((pixels & 1u) == 0)
+						continue;
+					if (fill)
+						*p |=   1u << ((y + j) & 7);
+					else
+						*p &= ~(1u << ((y + j) & 7));
+				}
+			}
+		}
+	}
+#endif
+
 void UI_DisplayFrequency(const char *pDigits, uint8_t X, uint8_t Y, bool bDisplayLeadingZero, bool flag)
 {
 	const unsigned int char_width  = 13;
@@ -28,6 +28,9 @@ void UI_PrintStringSmall(const char *pString, uint8_t Start, uint8_t End, uint8_
 	void UI_PrintStringSmallBold(const char *pString, uint8_t Start, uint8_t End, uint8_t Line);
 #endif
 void UI_PrintStringSmallBuffer(const char *pString, uint8_t *buffer);
+#ifdef ENABLE_SPECTRUM
+	void UI_PrintStringSmallest(const char *pString, uint8_t x, uint8_t y, bool statusbar, bool fill);
+#endif
 void UI_DisplayFrequency(const char *pDigits, uint8_t X, uint8_t Y, bool bDisplayLeadingZero, bool flag);
 void UI_DisplayFrequencySmall(const char *pDigits, uint8_t X, uint8_t Y, bool bDisplayLeadingZero);
 void UI_Displaysmall_digits(const uint8_t size, const char *str, const uint8_t x, const uint8_t y, const bool display_leading_zeros);
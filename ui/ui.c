@@ -22,6 +22,9 @@
 #endif
 #include "app/scanner.h"
 #include "driver/keyboard.h"
+#ifdef ENABLE_PROFILER
+	#include "helper/profiler.h"
+#endif
 #include "misc.h"
 #ifdef ENABLE_AIRCOPY
 	#include "ui/aircopy.h"
@@ -43,6 +46,10 @@ bool               g_ask_to_delete;
 
 void GUI_DisplayScreen(void)
 {
+	#ifdef ENABLE_PROFILER
+		const uint32_t start = PROFILER_Stamp();
+	#endif
+
 	g_update_display = false;
 
 	switch (g_screen_to_display)
@@ -74,6 +81,10 @@ void GUI_DisplayScreen(void)
 		default:
 			break;
 	}
+
+	#ifdef ENABLE_PROFILER
+		PROFILER_Record(PROFILE_DISPLAY_SCREEN, start);
+	#endif
 }
 
 void GUI_SelectNextDisplay(gui_display_type_t Display)